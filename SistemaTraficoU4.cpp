@@ -1,565 +1,518 @@
 #include <iostream>
-#include <vector>
-#include <list>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <queue>
-#include <limits>
-#include <iomanip>
-#include <ctime>
-#include <unordered_map>
-#include <algorithm>
-#include <cmath>
+#include <unistd.h>
+#include "trafico/trafico.h"
+#include "benchmarks/benchmarks.h"
 
 using namespace std;
+using namespace trafico;
 
-// Estructuras para el Grafo
-struct Arista {
-    int to;
-    float w;
-};
-
-struct Nodo {
-    int id;
-    string nombre;
-    vector<Arista> adj;
-};
-
-class Grafo {
-private:
-    vector<Nodo> nodos;
-    unordered_map<string, int> nombreToId;
-    int numNodos;
-
-    void dfsRec(int u, vector<bool>& visit, vector<int>& orden) {
-        visit[u] = true;
-        orden.push_back(u);
-        for (const auto& a : nodos[u].adj) {
-            int v = a.to;
-            if (!visit[v]) {
-                dfsRec(v, visit, orden);
-            }
-        }
-    }
-
-public:
-    Grafo() : numNodos(0) {}
-
-    void altaNodo(int id, string nombre) {
-        if (id >= static_cast<int>(nodos.size())) nodos.resize(id + 1);
-        nodos[id].id = id;
-        nodos[id].nombre = nombre;
-        nombreToId[nombre] = id;
-        numNodos = max(numNodos, id + 1);
+// Tabla de memoria por componente con totales; devuelve vivos + holgura
+size_t mostrarMemoria(const string& titulo, const vector<UsoMemoria>& rep) {
+    auto kb = [](size_t bytes) {
+        ostringstream ss;
+        ss << fixed << setprecision(1) << bytes / 1024.0 << " KB";
+        return ss.str();
+    };
+    UsoMemoria total{"Total"};
+    cout << "\n========== MEMORIA: " << titulo << " ==========\n";
+    cout << left << setw(24) << "Componente" << right << setw(14) << "En uso"
+         << setw(14) << "Holgura" << setw(14) << "Asignaciones" << endl;
+    cout << string(66, '-') << endl;
+    for (const auto& u : rep) {
+        cout << left << setw(24) << u.componente << right << setw(14) << kb(u.vivos)
+             << setw(14) << kb(u.holgura) << setw(14) << u.asignaciones << endl;
+        total.vivos += u.vivos;
+        total.holgura += u.holgura;
+        total.asignaciones += u.asignaciones;
     }
+    cout << string(66, '-') << endl;
+    cout << left << setw(24) << total.componente << right << setw(14) << kb(total.vivos)
+         << setw(14) << kb(total.holgura) << setw(14) << total.asignaciones << endl;
+    cout << left;
+    return total.vivos + total.holgura;
+}
 
-    void bajaNodo(int id) {
-        if (id >= 0 && id < static_cast<int>(nodos.size())) {
-            nodos[id].adj.clear();
-            for (auto& n : nodos) {
-                n.adj.erase(remove_if(n.adj.begin(), n.adj.end(), 
-                    [id](const Arista& a){ return a.to == id; }), n.adj.end());
+// Consulta de las metricas acumuladas desde el arranque (o el ultimo reinicio).
+// El volcado JSON acepta "-" como archivo para escribir en la salida estandar.
+void menuMetricas() {
+    int op;
+    cout << "\n========== METRICAS ==========\n";
+    cout << " 1) Mostrar resumen\n";
+    cout << " 2) Volcar a JSON\n";
+    cout << " 3) Reiniciar\n";
+    cout << " 0) Volver\n";
+    cout << "Opcion: ";
+    cin >> op;
+    
+    switch (op) {
+        case 1:
+            Metricas::global().mostrar(cout);
+            break;
+        case 2: {
+            string archivo;
+            cout << "Archivo de salida (- para pantalla): ";
+            cin >> archivo;
+            if (archivo == "-") {
+                Metricas::global().volcarJSON(cout);
+                break;
+            }
+            ofstream out(archivo);
+            if (!out.is_open()) {
+                cout << "Error: No se pudo crear el archivo " << archivo << endl;
+                break;
             }
-            nombreToId.erase(nodos[id].nombre);
-            nodos[id].nombre = "";
+            Metricas::global().volcarJSON(out);
+            cout << "Metricas guardadas en " << archivo << endl;
+            break;
         }
+        case 3:
+            Metricas::global().reiniciar();
+            cout << "Metricas reiniciadas.\n";
+            break;
+        default:
+            break;
     }
+}
 
-    void altaArista(int from, int to, float w) {
-        if (from >= 0 && from < static_cast<int>(nodos.size()) && to >= 0 && to < static_cast<int>(nodos.size()) && w >= 0) {
-            nodos[from].adj.push_back({to, w});
-        } else if (w < 0) {
-            cout << "Advertencia: No se permiten pesos negativos.\n";
+void menuBenchmarks() {
+    int op;
+    cout << "\n========== BENCHMARKS ==========\n";
+    cout << " 1) Tabla hash concurrente\n";
+    cout << " 2) Grafo versionado (lectores + escritor)\n";
+    cout << " 3) Simulacion de eventos discretos\n";
+    cout << " 4) Asignacion en equilibrio (Frank-Wolfe)\n";
+    cout << " 5) Rutas alternativas (Yen / penalizacion)\n";
+    cout << " 6) Reordenamiento de nodos (localidad)\n";
+    cout << " 7) Relajacion de aristas (escalar / SIMD)\n";
+    cout << " 8) Adyacencia comprimida\n";
+    cout << " 9) Prueba diferencial de motores de rutas\n";
+    cout << " 0) Volver\n";
+    cout << "Opcion: ";
+    cin >> op;
+    
+    switch (op) {
+        case 1: {
+            int numOps, escrituras;
+            cout << "Operaciones totales: ";
+            cin >> numOps;
+            cout << "Porcentaje de escrituras (0-100): ";
+            cin >> escrituras;
+            benchmarkHashConcurrente(max(numOps, 1), min(max(escrituras, 0), 100));
+            break;
         }
-    }
-
-    void bajaArista(int from, int to) {
-        if (from >= 0 && from < static_cast<int>(nodos.size())) {
-            nodos[from].adj.erase(remove_if(nodos[from].adj.begin(), nodos[from].adj.end(), 
-                [to](const Arista& a){ return a.to == to; }), nodos[from].adj.end());
+        case 2: {
+            int lado, segundos, lectores;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Segundos por corrida: ";
+            cin >> segundos;
+            cout << "Hilos lectores: ";
+            cin >> lectores;
+            benchmarkVersiones(max(lado, 2), max(segundos, 1), max(lectores, 1));
+            break;
         }
-    }
-
-    void mostrarListaAdj() {
-        cout << "\n========== LISTA DE ADYACENCIA ==========\n";
-        for (const auto& n : nodos) {
-            if (!n.nombre.empty()) {
-                cout << n.nombre << " (" << n.id << "): ";
-                for (const auto& a : n.adj) {
-                    cout << "-> " << nodos[a.to].nombre << "(" << a.w << ") ";
-                }
-                cout << endl;
-            }
+        case 3: {
+            int lado, vehiculos, zonas, hilos;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Vehiculos: ";
+            cin >> vehiculos;
+            cout << "Zonas de origen/destino: ";
+            cin >> zonas;
+            cout << "Hilos para el calculo de rutas: ";
+            cin >> hilos;
+            benchmarkSimulacion(max(lado, 2), max(vehiculos, 1), max(zonas, 1), max(hilos, 1));
+            break;
         }
-    }
-
-    void mostrarMatriz() {
-        const float INF = numeric_limits<float>::infinity();
-        vector<vector<float>> mat(numNodos, vector<float>(numNodos, INF));
-        
-        for (int i = 0; i < numNodos; ++i) {
-            for (const auto& a : nodos[i].adj) {
-                mat[i][a.to] = a.w;
-            }
+        case 4: {
+            int lado, vehiculos, zonas, iteraciones;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Viajes: ";
+            cin >> vehiculos;
+            cout << "Zonas de origen/destino: ";
+            cin >> zonas;
+            cout << "Iteraciones: ";
+            cin >> iteraciones;
+            benchmarkAsignacion(max(lado, 2), max(vehiculos, 1), max(zonas, 1), max(iteraciones, 1));
+            break;
         }
-        
-        cout << "\n========== MATRIZ DE ADYACENCIA ==========\n";
-        cout << setw(12) << " ";
-        for (int i = 0; i < numNodos; ++i) {
-            if (!nodos[i].nombre.empty()) 
-                cout << setw(10) << nodos[i].nombre.substr(0, 9);
+        case 5: {
+            int lado, consultas, k;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Consultas: ";
+            cin >> consultas;
+            cout << "Rutas por consulta (k): ";
+            cin >> k;
+            benchmarkAlternativas(max(lado, 2), max(consultas, 1), max(k, 1));
+            break;
         }
-        cout << endl;
-        
-        for (int i = 0; i < numNodos; ++i) {
-            if (!nodos[i].nombre.empty()) {
-                cout << setw(12) << nodos[i].nombre.substr(0, 11);
-                for (int j = 0; j < numNodos; ++j) {
-                    if (!nodos[j].nombre.empty()) {
-                        if (mat[i][j] == INF) 
-                            cout << setw(10) << "INF";
-                        else 
-                            cout << setw(10) << fixed << setprecision(1) << mat[i][j];
-                    }
-                }
-                cout << endl;
-            }
+        case 6: {
+            int lado, consultas;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Consultas por orden: ";
+            cin >> consultas;
+            benchmarkReordenamiento(max(lado, 2), max(consultas, 1));
+            break;
         }
-    }
-
-    void mostrarASCII() {
-        cout << "\n========== MAPA ASCII DE LA RED ==========\n";
-        if (numNodos == 0) {
-            cout << "Red vacia.\n";
-            return;
+        case 7: {
+            int lado, hubs, grado, consultas;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Numero de hubs: ";
+            cin >> hubs;
+            cout << "Conexiones por hub: ";
+            cin >> grado;
+            cout << "Consultas: ";
+            cin >> consultas;
+            benchmarkRelajacion(max(lado, 2), max(hubs, 0), max(grado, 1), max(consultas, 1));
+            break;
         }
-        
-        int filas = (int)sqrt(numNodos) + 1;
-        int cols = (int)sqrt(numNodos) + 2;
-        vector<vector<string>> grid(filas * 2 + 1, vector<string>(cols * 3, "  "));
-        
-        int idx = 0;
-        for (int i = 0; i < numNodos && idx < filas * cols; ++i) {
-            if (!nodos[i].nombre.empty()) {
-                int fila = (idx / cols) * 2;
-                int col = (idx % cols) * 3;
-                string label = nodos[i].nombre.substr(0, 3);
-                grid[fila][col] = "[" + label.substr(0, 1) + "]";
-                idx++;
-            }
+        case 8: {
+            int lado, consultas;
+            cout << "Lado de la rejilla: ";
+            cin >> lado;
+            cout << "Consultas: ";
+            cin >> consultas;
+            benchmarkCompresion(max(lado, 2), max(consultas, 1));
+            break;
         }
-        
-        for (const auto& row : grid) {
-            for (const auto& cell : row) {
-                cout << cell;
-            }
-            cout << endl;
+        case 9: {
+            int rondas;
+            unsigned semilla;
+            cout << "Rondas (redes por escenario): ";
+            cin >> rondas;
+            cout << "Semilla: ";
+            cin >> semilla;
+            pruebaDiferencial(max(rondas, 1), semilla);
+            break;
         }
+        default:
+            break;
     }
+}
 
-    void dijkstra(int s, int e) {
-        const float INF = numeric_limits<float>::infinity();
-        vector<float> dist(numNodos, INF);
-        vector<int> previo(numNodos, -1);
-        vector<bool> visit(numNodos, false);
-        
-        dist[s] = 0;
-        priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
-        pq.push({0, s});
-        
-        clock_t inicio = clock();
-        
-        while (!pq.empty()) {
-            int u = pq.top().second;
-            pq.pop();
-            
-            if (visit[u]) continue;
-            visit[u] = true;
-            
-            for (const auto& a : nodos[u].adj) {
-                int v = a.to;
-                float w = a.w;
-                if (!visit[v] && dist[u] + w < dist[v]) {
-                    dist[v] = dist[u] + w;
-                    previo[v] = u;
-                    pq.push({dist[v], v});
-                }
-            }
-        }
-        
-        clock_t fin = clock();
-        double tiempo = (double)(fin - inicio) / CLOCKS_PER_SEC;
-        
-        cout << "\n========== DIJKSTRA: RUTA MAS CORTA ==========\n";
-        if (dist[e] == INF) {
-            cout << "No hay camino entre " << nodos[s].nombre << " y " << nodos[e].nombre << endl;
-        } else {
-            cout << "Distancia total: " << fixed << setprecision(2) << dist[e] << endl;
-            
-            vector<int> camino;
-            for (int at = e; at != -1; at = previo[at]) {
-                camino.push_back(at);
-            }
-            reverse(camino.begin(), camino.end());
-            
-            cout << "Camino: ";
-            for (size_t i = 0; i < camino.size(); ++i) {
-                cout << nodos[camino[i]].nombre;
-                if (i < camino.size() - 1) cout << " -> ";
-            }
-            cout << endl;
-            cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
-        }
-    }
+// Hace durable lo registrado antes de aplicarlo: si falla, el cambio no se
+// aplica ni se informa como hecho
+bool confirmarCambio(Bitacora& bitacora) {
+    if (bitacora.confirmar()) return true;
+    cout << "Error: No se aplico el cambio (" << bitacora.tomarError() << ").\n";
+    return false;
+}
 
-    void bfs(int s) {
-        queue<int> q;
-        vector<bool> visit(numNodos, false);
-        visit[s] = true;
-        q.push(s);
-        vector<int> orden;
-        
-        clock_t inicio = clock();
-        
-        while (!q.empty()) {
-            int u = q.front(); 
-            q.pop();
-            orden.push_back(u);
-            
-            for (const auto& a : nodos[u].adj) {
-                int v = a.to;
-                if (!visit[v]) {
-                    visit[v] = true;
-                    q.push(v);
-                }
+// Sigue una fuente de eventos y aplica cada lote a la tabla hasta que la
+// fuente se cierra o pasan 'esperaSeg' segundos sin datos nuevos
+void ingerirStream(HashTable& ht, const string& fuente, int esperaSeg, int tamLote, Bitacora* bitacora = nullptr) {
+    IngestorVehiculos ingestor;
+    if (!ingestor.abrir(fuente)) {
+        cout << "Error: No se pudo abrir " << fuente << endl;
+        return;
+    }
+    
+    cout << "Leyendo eventos de " << fuente << "...\n";
+    vector<EventoVehiculo> lote;
+    lote.reserve(tamLote);
+    int lotes = 0, eventos = 0, altas = 0, bajas = 0;
+    auto inicio = chrono::steady_clock::now();
+    
+    while (ingestor.leerLote(lote, tamLote, esperaSeg * 1000)) {
+        // Cada lote se confirma con un solo fsync antes de aplicarlo
+        if (bitacora) {
+            for (const auto& ev : lote) {
+                if (ev.alta) bitacora->altaVehiculo(ev.v);
+                else bitacora->bajaVehiculo(ev.v.id);
             }
+            if (!confirmarCambio(*bitacora)) break;
         }
-        
-        clock_t fin = clock();
-        double tiempo = (double)(fin - inicio) / CLOCKS_PER_SEC;
-        
-        cout << "\n========== BFS (Busqueda en Anchura) ==========\n";
-        cout << "Desde: " << nodos[s].nombre << endl;
-        cout << "Orden de visita: ";
-        for (int id : orden) {
-            cout << nodos[id].nombre << " ";
-        }
-        cout << "\nNodos alcanzados: " << orden.size() << endl;
-        cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+        ht.aplicarLote(lote, altas, bajas);
+        eventos += static_cast<int>(lote.size());
+        lotes++;
     }
+    
+    double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cout << "\n========== INGESTA DE EVENTOS ==========\n";
+    cout << "Eventos leidos: " << eventos << " en " << lotes << " lotes\n";
+    cout << "Altas aplicadas: " << altas << ", bajas aplicadas: " << bajas << endl;
+    cout << "Lineas invalidas: " << ingestor.lineasInvalidas << endl;
+    cout << "Tiempo total: " << fixed << setprecision(3) << seg << " segundos\n";
+}
 
-    void dfs(int s) {
-        vector<bool> visit(numNodos, false);
-        vector<int> orden;
-        
-        clock_t inicio = clock();
-        dfsRec(s, visit, orden);
-        clock_t fin = clock();
-        
-        double tiempo = (double)(fin - inicio) / CLOCKS_PER_SEC;
-        
-        cout << "\n========== DFS (Busqueda en Profundidad) ==========\n";
-        cout << "Desde: " << nodos[s].nombre << endl;
-        cout << "Orden de visita: ";
-        for (int id : orden) {
-            cout << nodos[id].nombre << " ";
+void mostrarListaAdj(const Grafo& g) {
+    cout << "\n========== LISTA DE ADYACENCIA ==========\n";
+    SalidaBuffer out(cout);
+    escribirListaAdj(out, g, FormatoReporte::Texto);
+}
+
+void mostrarMatriz(const Grafo& g) {
+    const auto& nodos = g.getNodos();
+    int numNodos = g.getNumNodos();
+    const float INF = numeric_limits<float>::infinity();
+    vector<vector<float>> mat(numNodos, vector<float>(numNodos, INF));
+    
+    for (int i = 0; i < numNodos; ++i) {
+        for (const auto& a : nodos[i].adj) {
+            mat[i][a.to] = a.w;
         }
-        cout << "\nNodos alcanzados: " << orden.size() << endl;
-        cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
     }
-
-    int componentesConexas() {
-        vector<bool> visit(numNodos, false);
-        int count = 0;
-        
-        cout << "\n========== COMPONENTES CONEXAS ==========\n";
-        
-        for (int i = 0; i < numNodos; ++i) {
-            if (!visit[i] && !nodos[i].nombre.empty()) {
-                count++;
-                cout << "Componente " << count << ": ";
-                
-                queue<int> q;
-                visit[i] = true;
-                q.push(i);
-                
-                while (!q.empty()) {
-                    int u = q.front(); 
-                    q.pop();
-                    cout << nodos[u].nombre << " ";
-                    
-                    for (const auto& a : nodos[u].adj) {
-                        int v = a.to;
-                        if (!visit[v]) {
-                            visit[v] = true;
-                            q.push(v);
-                        }
-                    }
+    
+    cout << "\n========== MATRIZ DE ADYACENCIA ==========\n";
+    cout << setw(12) << " ";
+    for (int i = 0; i < numNodos; ++i) {
+        if (!nodos[i].nombre.empty()) 
+            cout << setw(10) << nodos[i].nombre.substr(0, 9);
+    }
+    cout << endl;
+    
+    for (int i = 0; i < numNodos; ++i) {
+        if (!nodos[i].nombre.empty()) {
+            cout << setw(12) << nodos[i].nombre.substr(0, 11);
+            for (int j = 0; j < numNodos; ++j) {
+                if (!nodos[j].nombre.empty()) {
+                    if (mat[i][j] == INF) 
+                        cout << setw(10) << "INF";
+                    else 
+                        cout << setw(10) << fixed << setprecision(1) << mat[i][j];
                 }
-                cout << endl;
             }
+            cout << endl;
         }
-        
-        cout << "Total de componentes: " << count << endl;
-        return count;
     }
+}
 
-    void detectarCuellos() {
-        cout << "\n========== CUELLOS DE BOTELLA ==========\n";
-        cout << "(Nodos con alto grado de conexion)\n\n";
-        
-        vector<pair<int, int>> grados;
-        
-        for (int i = 0; i < numNodos; ++i) {
-            if (!nodos[i].nombre.empty()) {
-                int gradoSalida = static_cast<int>(nodos[i].adj.size());
-                int gradoEntrada = 0;
-                
-                for (int j = 0; j < numNodos; ++j) {
-                    for (const auto& a : nodos[j].adj) {
-                        if (a.to == i) gradoEntrada++;
-                    }
-                }
-                
-                int gradoTotal = gradoSalida + gradoEntrada;
-                grados.push_back({gradoTotal, i});
-            }
+void mostrarASCII(const Grafo& g) {
+    const auto& nodos = g.getNodos();
+    int numNodos = g.getNumNodos();
+    cout << "\n========== MAPA ASCII DE LA RED ==========\n";
+    if (numNodos == 0) {
+        cout << "Red vacia.\n";
+        return;
+    }
+    
+    int filas = (int)sqrt(numNodos) + 1;
+    int cols = (int)sqrt(numNodos) + 2;
+    vector<vector<string>> grid(filas * 2 + 1, vector<string>(cols * 3, "  "));
+    
+    int idx = 0;
+    for (int i = 0; i < numNodos && idx < filas * cols; ++i) {
+        if (!nodos[i].nombre.empty()) {
+            int fila = (idx / cols) * 2;
+            int col = (idx % cols) * 3;
+            string label(nodos[i].nombre.substr(0, 3));
+            grid[fila][col] = "[" + label.substr(0, 1) + "]";
+            idx++;
         }
-        
-        sort(grados.rbegin(), grados.rend());
-        
-        cout << setw(20) << "Nodo" << setw(15) << "Grado Total" 
-            << setw(12) << "Entrada" << setw(12) << "Salida" << endl;
-        cout << string(60, '-') << endl;
-        
-        for (const auto& par : grados) {
-            int id = par.second;
-            int total = par.first;
-            int salida = static_cast<int>(nodos[id].adj.size());
-            int entrada = total - salida;
-            
-            cout << setw(20) << nodos[id].nombre 
-                << setw(15) << total 
-                << setw(12) << entrada 
-                << setw(12) << salida << endl;
+    }
+    
+    for (const auto& row : grid) {
+        for (const auto& cell : row) {
+            cout << cell;
         }
+        cout << endl;
     }
+}
 
-    void cargar(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Error: No se pudo abrir el archivo " << filename << endl;
-            return;
-        }
+void mostrarRutaMasCorta(const Grafo& g, int s, int e) {
+    auto inicio = chrono::steady_clock::now();
+    Ruta ruta = g.rutaMasCorta(s, e);
+    double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    
+    cout << "\n========== DIJKSTRA: RUTA MAS CORTA ==========\n";
+    if (ruta.camino.empty()) {
+        cout << "No hay camino entre " << g.getNameById(s) << " y " << g.getNameById(e) << endl;
+    } else {
+        cout << "Distancia total: " << fixed << setprecision(2) << ruta.distancia << endl;
         
-        string line;
-        while (getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
-            
-            stringstream ss(line);
-            string token;
-            getline(ss, token, ';');
-            string type = token;
-            
-            if (type == "N") {
-                getline(ss, token, ';'); 
-                int id = stoi(token);
-                getline(ss, token, ';'); 
-                string nombre = token;
-                altaNodo(id, nombre);
-            } else if (type == "E") {
-                getline(ss, token, ';'); 
-                int from = stoi(token);
-                getline(ss, token, ';'); 
-                int to = stoi(token);
-                getline(ss, token, ';'); 
-                float w = stof(token);
-                altaArista(from, to, w);
-            }
+        cout << "Camino: ";
+        for (size_t i = 0; i < ruta.camino.size(); ++i) {
+            cout << g.getNameById(ruta.camino[i]);
+            if (i < ruta.camino.size() - 1) cout << " -> ";
         }
-        file.close();
-        cout << "Red cargada exitosamente desde " << filename << endl;
+        cout << endl;
+        cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
     }
+}
 
-    void guardar(const string& filename) {
-        ofstream file(filename);
-        file << "# NODOS\n";
-        for (const auto& n : nodos) {
-            if (!n.nombre.empty()) {
-                file << "N;" << n.id << ";" << n.nombre << "\n";
-            }
-        }
-        file << "# ARISTAS\n";
-        for (int i = 0; i < numNodos; ++i) {
-            for (const auto& a : nodos[i].adj) {
-                file << "E;" << i << ";" << a.to << ";" << a.w << "\n";
-            }
-        }
-        file.close();
-        cout << "Red guardada exitosamente en " << filename << endl;
+void mostrarRecorrido(const Grafo& g, int s, bool anchura) {
+    auto inicio = chrono::steady_clock::now();
+    vector<int> orden = anchura ? g.recorridoAnchura(s) : g.recorridoProfundidad(s);
+    double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    
+    cout << (anchura ? "\n========== BFS (Busqueda en Anchura) ==========\n"
+                     : "\n========== DFS (Busqueda en Profundidad) ==========\n");
+    cout << "Desde: " << g.getNameById(s) << endl;
+    cout << "Orden de visita: ";
+    {
+        SalidaBuffer out(cout);
+        escribirRecorrido(out, g, orden, FormatoReporte::Texto);
     }
+    cout << "\nNodos alcanzados: " << orden.size() << endl;
+    cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+}
 
-    int getIdByName(const string& name) { 
-        if (nombreToId.find(name) != nombreToId.end())
-            return nombreToId[name];
-        return -1;
-    }
-    
-    string getNameById(int id) { 
-        if (id >= 0 && id < static_cast<int>(nodos.size()))
-            return nodos[id].nombre;
-        return "";
+// Reporte 1 = lista de adyacencia, 2 = BFS, 3 = DFS desde s. archivo "-" = pantalla.
+void exportarReporte(const Grafo& g, int reporte, int s, FormatoReporte formato,
+                     const FiltroReporte& filtro, const string& archivo) {
+    ofstream fout;
+    if (archivo != "-") {
+        fout.open(archivo, ios::binary);
+        if (!fout) {
+            cout << "Error: No se pudo crear el archivo " << archivo << endl;
+            return;
+        }
     }
+    ostream& destino = archivo == "-" ? static_cast<ostream&>(cout) : fout;
     
-    int getNumNodos() { return numNodos; }
-};
-
-// Estructura para Vehículo
-struct Vehiculo {
-    string id, tipo, placa;
-    int origen, destino;
-    string horaEntrada;
-};
-
-// Tabla Hash con encadenamiento
-class HashTable {
-private:
-    vector<list<pair<string, Vehiculo>>> table;
-    int size;
-    int count;
-
-    int hashFunc(const string& key) {
-        int hash = 0;
-        for (char c : key) {
-            hash = (hash * 31 + c) % size;
+    auto inicio = chrono::steady_clock::now();
+    ResumenReporte res;
+    size_t bytes;
+    {
+        SalidaBuffer out(destino);
+        if (reporte == 1) {
+            res = escribirListaAdj(out, g, formato, filtro);
+        } else {
+            vector<int> orden = reporte == 2 ? g.recorridoAnchura(s) : g.recorridoProfundidad(s);
+            res = escribirRecorrido(out, g, orden, formato, filtro);
+            if (formato == FormatoReporte::Texto) out.caracter('\n');
         }
-        return hash;
+        out.vaciar();
+        bytes = out.bytesEscritos();
     }
-
-public:
-    HashTable(int sz = 100) : size(sz), count(0) { 
-        table.resize(size); 
+    destino.flush();
+    double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    if (!destino) {
+        cout << "Error: No se pudo escribir " << archivo << endl;
+        return;
     }
+    
+    size_t paginas = filtro.porPagina ? (res.total + filtro.porPagina - 1) / filtro.porPagina : 1;
+    cout << "\n========== REPORTE ==========\n";
+    cout << "Nodos escritos: " << res.escritas << " de " << res.total;
+    if (filtro.porPagina) cout << " (pagina " << filtro.pagina + 1 << " de " << max<size_t>(paginas, 1) << ")";
+    cout << endl;
+    cout << "Bytes: " << bytes << ", tiempo: " << fixed << setprecision(3) << seg << " segundos\n";
+}
 
-    void insert(const string& key, const Vehiculo& v) {
-        int idx = hashFunc(key);
-        
-        for (auto& p : table[idx]) {
-            if (p.first == key) {
-                p.second = v;
-                return;
-            }
-        }
-        
-        table[idx].push_back({key, v});
-        count++;
+void mostrarComponentes(const Grafo& g) {
+    vector<vector<int>> componentes = g.componentesConexas();
+    cout << "\n========== COMPONENTES CONEXAS ==========\n";
+    for (size_t c = 0; c < componentes.size(); ++c) {
+        cout << "Componente " << c + 1 << ": ";
+        for (int id : componentes[c]) cout << g.getNameById(id) << " ";
+        cout << endl;
     }
+    cout << "Total de componentes: " << componentes.size() << endl;
+}
 
-    Vehiculo* search(const string& key) {
-        int idx = hashFunc(key);
-        for (auto& p : table[idx]) {
-            if (p.first == key) return &p.second;
-        }
-        return nullptr;
+void mostrarCuellos(const Grafo& g) {
+    cout << "\n========== CUELLOS DE BOTELLA ==========\n";
+    cout << "(Nodos con alto grado de conexion)\n\n";
+    cout << setw(20) << "Nodo" << setw(15) << "Grado Total" 
+        << setw(12) << "Entrada" << setw(12) << "Salida" << endl;
+    cout << string(60, '-') << endl;
+    
+    for (const GradoNodo& gn : g.detectarCuellos()) {
+        cout << setw(20) << g.getNameById(gn.id) 
+            << setw(15) << gn.entrada + gn.salida 
+            << setw(12) << gn.entrada 
+            << setw(12) << gn.salida << endl;
     }
+}
 
-    void remove(const string& key) {
-        int idx = hashFunc(key);
-        auto it = table[idx].begin();
-        while (it != table[idx].end()) {
-            if (it->first == key) {
-                table[idx].erase(it);
-                count--;
-                return;
-            }
-            ++it;
-        }
-    }
+void mostrarInfoHash(const HashTable& ht) {
+    EstadisticasHash e = ht.estadisticas();
+    cout << "\n========== INFORMACION TABLA HASH ==========\n";
+    cout << "Funcion hash: Modular (h(k) = k mod " << e.tamTabla << ")\n";
+    cout << "Resolucion de colisiones: Encadenamiento\n";
+    cout << "Tamaño de tabla: " << e.tamTabla << endl;
+    cout << "Vehiculos registrados: " << e.vehiculos << endl;
+    cout << "Factor de carga: " << fixed << setprecision(3) 
+         << (float)e.vehiculos / e.tamTabla << endl;
+    cout << "Buckets ocupados: " << e.bucketsUsados << " / " << e.tamTabla 
+         << " (" << fixed << setprecision(1) 
+         << (100.0 * e.bucketsUsados / e.tamTabla) << "%)\n";
+    cout << "Cadena mas larga: " << e.cadenaMasLarga << " elementos\n";
+    cout << "Indices secundarios: " << e.placas << " placas, "
+         << e.origenes << " origenes, " << e.destinos << " destinos, "
+         << e.tipos << " tipos\n";
+}
 
-    void info() {
-        cout << "\n========== INFORMACION TABLA HASH ==========\n";
-        cout << "Funcion hash: Modular (h(k) = k mod " << size << ")\n";
-        cout << "Resolucion de colisiones: Encadenamiento\n";
-        cout << "Tamaño de tabla: " << size << endl;
-        cout << "Vehiculos registrados: " << count << endl;
-        cout << "Factor de carga: " << fixed << setprecision(3) 
-             << (float)count / size << endl;
-        
-        int buckets_usados = 0;
-        int max_cadena = 0;
-        
-        for (const auto& bucket : table) {
-            if (!bucket.empty()) {
-                buckets_usados++;
-                max_cadena = max(max_cadena, static_cast<int>(bucket.size()));
-            }
+void mostrarCarga(const ResultadoCarga& res, const string& archivoRed, const string& archivoVehiculos) {
+    if (!res.redLeida) {
+        cout << "Error: No se pudo abrir el archivo " << archivoRed << endl;
+    } else {
+        for (const auto& adv : res.advertenciasRed) cout << "Advertencia: " << adv << endl;
+        cout << "Red cargada exitosamente desde " << archivoRed << endl;
+    }
+    if (!res.vehiculosLeidos) {
+        cout << "Advertencia: No se pudo abrir " << archivoVehiculos << endl;
+    } else {
+        cout << res.vehiculos << " vehiculos cargados desde " << archivoVehiculos << endl;
+        if (!res.invalidos.empty()) {
+            cout << "Advertencia: " << res.invalidos.size() << " vehiculos con origen o destino inexistente:";
+            for (size_t i = 0; i < res.invalidos.size() && i < 10; ++i) cout << " " << res.invalidos[i];
+            if (res.invalidos.size() > 10) cout << " ...";
+            cout << endl;
         }
-        
-        cout << "Buckets ocupados: " << buckets_usados << " / " << size 
-             << " (" << fixed << setprecision(1) 
-             << (100.0 * buckets_usados / size) << "%)\n";
-        cout << "Cadena mas larga: " << max_cadena << " elementos\n";
     }
+    cout << "Carga completa en " << fixed << setprecision(3) << res.segundos << " s (red " << res.segRed
+         << " s, vehiculos " << res.segVehiculos << " s)\n";
+}
 
-    void cargar(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Advertencia: No se pudo abrir " << filename << endl;
-            return;
-        }
-        
-        string line;
-        while (getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
-            
-            stringstream ss(line);
-            string token;
-            getline(ss, token, ';');
-            string type = token;
-            
-            if (type == "V") {
-                Vehiculo v;
-                getline(ss, token, ';'); v.id = token;
-                getline(ss, token, ';'); v.tipo = token;
-                getline(ss, token, ';'); v.placa = token;
-                getline(ss, token, ';'); v.origen = stoi(token);
-                getline(ss, token, ';'); v.destino = stoi(token);
-                getline(ss, token, ';'); v.horaEntrada = token;
-                insert(v.id, v);
-            }
-        }
-        file.close();
-        cout << "Vehiculos cargados desde " << filename << endl;
+// Informa los fallos de la bitacora y las compactaciones hechas desde la
+// ultima llamada, incluidas las automaticas
+void informarBitacora(Bitacora& bitacora, int& generacionVista) {
+    string error = bitacora.tomarError();
+    if (!error.empty()) cout << "Advertencia: " << error << endl;
+    if (bitacora.getGeneracion() != generacionVista) {
+        generacionVista = bitacora.getGeneracion();
+        cout << "Bitacora compactada (generacion " << generacionVista << ")\n";
     }
+}
 
-    void guardar(const string& filename) {
-        ofstream file(filename);
-        file << "# idVehiculo;tipo;placa;origen;destino;horaEntrada\n";
-        for (const auto& lst : table) {
-            for (const auto& p : lst) {
-                const Vehiculo& v = p.second;
-                file << "V;" << v.id << ";" << v.tipo << ";" << v.placa << ";" 
-                     << v.origen << ";" << v.destino << ";" << v.horaEntrada << "\n";
-            }
-        }
-        file.close();
-        cout << "Vehiculos guardados en " << filename << endl;
+void mostrarVehiculo(const Vehiculo& v) {
+    cout << "\n========== INFORMACION DEL VEHICULO ==========\n";
+    cout << "ID: " << v.id << endl;
+    cout << "Tipo: " << v.tipo << endl;
+    cout << "Placa: " << v.placa << endl;
+    cout << "Origen: " << v.origen << endl;
+    cout << "Destino: " << v.destino << endl;
+    cout << "Hora de entrada: " << v.horaEntrada << endl;
+}
+
+void mostrarVehiculos(vector<Vehiculo*> lista) {
+    sort(lista.begin(), lista.end(), [](const Vehiculo* a, const Vehiculo* b) { return a->id < b->id; });
+    cout << setw(10) << "ID" << setw(12) << "Tipo" << setw(10) << "Placa"
+         << setw(8) << "Origen" << setw(9) << "Destino" << setw(7) << "Hora" << endl;
+    cout << string(56, '-') << endl;
+    for (const Vehiculo* v : lista) {
+        cout << setw(10) << v->id << setw(12) << v->tipo << setw(10) << v->placa
+             << setw(8) << v->origen << setw(9) << v->destino << setw(7) << v->horaEntrada << endl;
     }
-};
+    cout << "Total: " << lista.size() << " vehiculos\n";
+}
 
 int main() {
     Grafo g;
     HashTable ht;
+    Bitacora bitacora(g, ht);
+    OrdenNodos ordenCSR = OrdenNodos::Original;  // orden de la red para simulacion y rutas
+    string archivoVehiculos = "vehiculos.csv";
     int opcion;
     
     cout << "\n================================================\n";
     cout << "   SIMULADOR DE TRAFICO URBANO - VERSION 1.0\n";
     cout << "================================================\n";
     
+    int recuperados = bitacora.recuperar();
+    if (recuperados > 0) {
+        cout << "Bitacora: " << recuperados << " cambios recuperados desde la ultima instantanea.\n";
+    }
+    int generacionVista = bitacora.getGeneracion();
+    
     do {
+        informarBitacora(bitacora, generacionVista);
         cout << "\n========== MENU PRINCIPAL ==========\n";
         cout << " 1) CargarRed       2) GuardarRed      3) AltaNodo\n";
         cout << " 4) AltaArista      5) BajaNodo        6) BajaArista\n";
@@ -567,6 +520,13 @@ int main() {
         cout << "10) BFS            11) DFS            12) AltaVeh\n";
         cout << "13) BuscarVeh      14) BajaVeh        15) InfoHash\n";
         cout << "16) MostrarASCII   17) Componentes    18) CuellosBotella\n";
+        cout << "19) BuscarPlaca    20) VehPorNodo     21) VehPorTipo\n";
+        cout << "22) VehPorHora     23) Benchmarks     24) IngestaStream\n";
+        cout << "25) Compactar      26) Simular        27) RutaPorHora\n";
+        cout << "28) Equilibrio     29) RutasAlternas  30) Isocrona\n";
+        cout << "31) BuscarNombre   32) Metricas       33) Traza\n";
+        cout << "34) Memoria        35) Reordenar      36) RutaComprimida\n";
+        cout << "37) Servidor       38) ImportarRed    39) ExportarReporte\n";
         cout << " 0) Salir\n";
         cout << "====================================\n";
         cout << "Opcion: ";
@@ -575,19 +535,24 @@ int main() {
         
         switch (opcion) {
             case 1: {
-                string file; 
+                string file, veh; 
                 cout << "Archivo de red: "; 
                 getline(cin, file);
-                g.cargar(file);
-                ht.cargar("vehiculos.csv");
+                cout << "Archivo de vehiculos (Enter = " << archivoVehiculos << "): ";
+                getline(cin, veh);
+                if (!veh.empty()) archivoVehiculos = veh;
+                mostrarCarga(cargarRedYVehiculos(g, ht, file, archivoVehiculos), file, archivoVehiculos);
+                bitacora.compactar();
                 break;
             }
             case 2: {
                 string file; 
                 cout << "Archivo de red: "; 
                 getline(cin, file);
-                g.guardar(file);
-                ht.guardar("vehiculos.csv");
+                if (g.guardar(file)) cout << "Red guardada exitosamente en " << file << endl;
+                else cout << "Error: No se pudo escribir " << file << endl;
+                if (ht.guardar(archivoVehiculos)) cout << "Vehiculos guardados en " << archivoVehiculos << endl;
+                else cout << "Error: No se pudo escribir " << archivoVehiculos << endl;
                 break;
             }
             case 3: {
@@ -598,6 +563,8 @@ int main() {
                 cin.ignore();
                 cout << "Nombre: "; 
                 getline(cin, nombre);
+                bitacora.altaNodo(id, nombre);
+                if (!confirmarCambio(bitacora)) break;
                 g.altaNodo(id, nombre);
                 cout << "Nodo agregado exitosamente.\n";
                 break;
@@ -611,7 +578,17 @@ int main() {
                 cin >> to;
                 cout << "Peso (distancia/tiempo): "; 
                 cin >> w;
-                g.altaArista(from, to, w);
+                // Un registro rechazado aqui tambien se rechaza al reproducirlo
+                bitacora.altaArista(from, to, w);
+                if (!confirmarCambio(bitacora)) break;
+                if (!g.altaArista(from, to, w)) {
+                    if (w < 0) cout << "Advertencia: No se permiten pesos negativos.\n";
+                    else if (from < 0 || from >= g.getNumNodos() || to < 0 || to >= g.getNumNodos())
+                        cout << "Error: Origen o destino inexistente.\n";
+                    else cout << "Advertencia: El perfil por hora de " << from << " -> " << to
+                              << " no cumpliria FIFO con ese peso.\n";
+                    break;
+                }
                 cout << "Arista agregada exitosamente.\n";
                 break;
             }
@@ -619,6 +596,8 @@ int main() {
                 int id; 
                 cout << "ID del nodo a eliminar: "; 
                 cin >> id;
+                bitacora.bajaNodo(id);
+                if (!confirmarCambio(bitacora)) break;
                 g.bajaNodo(id);
                 cout << "Nodo eliminado exitosamente.\n";
                 break;
@@ -629,15 +608,17 @@ int main() {
                 cin >> from;
                 cout << "Destino (ID): "; 
                 cin >> to;
+                bitacora.bajaArista(from, to);
+                if (!confirmarCambio(bitacora)) break;
                 g.bajaArista(from, to);
                 cout << "Arista eliminada exitosamente.\n";
                 break;
             }
             case 7: 
-                g.mostrarListaAdj(); 
+                mostrarListaAdj(g); 
                 break;
             case 8: 
-                g.mostrarMatriz(); 
+                mostrarMatriz(g); 
                 break;
             case 9: {
                 string start, end;
@@ -654,7 +635,7 @@ int main() {
                     break;
                 }
                 
-                g.dijkstra(s, e);
+                mostrarRutaMasCorta(g, s, e);
                 break;
             }
             case 10: {
@@ -668,7 +649,7 @@ int main() {
                     break;
                 }
                 
-                g.bfs(s);
+                mostrarRecorrido(g, s, true);
                 break;
             }
             case 11: {
@@ -682,7 +663,7 @@ int main() {
                     break;
                 }
                 
-                g.dfs(s);
+                mostrarRecorrido(g, s, false);
                 break;
             }
             case 12: {
@@ -701,6 +682,8 @@ int main() {
                 cout << "Hora de entrada (HH:MM): "; 
                 getline(cin, v.horaEntrada);
                 
+                bitacora.altaVehiculo(v);
+                if (!confirmarCambio(bitacora)) break;
                 ht.insert(v.id, v);
                 cout << "Vehiculo registrado exitosamente.\n";
                 break;
@@ -712,13 +695,7 @@ int main() {
                 
                 auto* v = ht.search(id);
                 if (v) {
-                    cout << "\n========== INFORMACION DEL VEHICULO ==========\n";
-                    cout << "ID: " << v->id << endl;
-                    cout << "Tipo: " << v->tipo << endl;
-                    cout << "Placa: " << v->placa << endl;
-                    cout << "Origen: " << v->origen << endl;
-                    cout << "Destino: " << v->destino << endl;
-                    cout << "Hora de entrada: " << v->horaEntrada << endl;
+                    mostrarVehiculo(*v);
                 } else {
                     cout << "Vehiculo no encontrado.\n";
                 }
@@ -728,22 +705,529 @@ int main() {
                 string id; 
                 cout << "ID del vehiculo: "; 
                 cin >> id;
+                bitacora.bajaVehiculo(id);
+                if (!confirmarCambio(bitacora)) break;
                 ht.remove(id);
                 cout << "Vehiculo eliminado exitosamente.\n";
                 break;
             }
             case 15: 
-                ht.info(); 
+                mostrarInfoHash(ht); 
                 break;
             case 16: 
-                g.mostrarASCII(); 
+                mostrarASCII(g); 
                 break;
             case 17: 
-                g.componentesConexas(); 
+                mostrarComponentes(g); 
                 break;
             case 18:
-                g.detectarCuellos();
+                mostrarCuellos(g);
+                break;
+            case 19: {
+                string placa;
+                cout << "Placa: ";
+                cin >> placa;
+                
+                vector<Vehiculo*> encontrados = ht.searchByPlaca(placa);
+                if (encontrados.empty()) {
+                    cout << "Vehiculo no encontrado.\n";
+                } else if (encontrados.size() == 1) {
+                    mostrarVehiculo(*encontrados[0]);
+                } else {
+                    cout << "Advertencia: La placa " << placa << " esta registrada en varios vehiculos.\n";
+                    mostrarVehiculos(encontrados);
+                }
+                break;
+            }
+            case 20: {
+                string nombre, sentido;
+                cout << "Nodo: ";
+                cin >> nombre;
+                cout << "Vehiculos que (S)alen o (L)legan: ";
+                cin >> sentido;
+                
+                int n = g.getIdByName(nombre);
+                if (n == -1) {
+                    cout << "Error: Nodo no encontrado.\n";
+                    break;
+                }
+                
+                bool llegan = !sentido.empty() && (sentido[0] == 'L' || sentido[0] == 'l');
+                cout << "\n========== VEHICULOS " << (llegan ? "CON DESTINO " : "CON ORIGEN ")
+                     << nombre << " ==========\n";
+                mostrarVehiculos(llegan ? ht.searchByDestino(n) : ht.searchByOrigen(n));
+                break;
+            }
+            case 21: {
+                string tipo;
+                cout << "Tipo (Particular/Transporte/Emergencia): ";
+                cin >> tipo;
+                cout << "\n========== VEHICULOS TIPO " << tipo << " ==========\n";
+                mostrarVehiculos(ht.searchByTipo(tipo));
+                break;
+            }
+            case 22: {
+                string desde, hasta;
+                int ventana;
+                cout << "Desde (HH:MM): ";
+                cin >> desde;
+                cout << "Hasta (HH:MM): ";
+                cin >> hasta;
+                cout << "Ventana de conteo en minutos (0 = solo listado): ";
+                cin >> ventana;
+                
+                int d = horaAMinutos(desde);
+                int h = horaAMinutos(hasta);
+                if (d == -1 || h == -1) {
+                    cout << "Error: Formato de hora invalido.\n";
+                    break;
+                }
+                
+                cout << "\n========== VEHICULOS ENTRE " << desde << " Y " << hasta << " ==========\n";
+                mostrarVehiculos(ht.searchByHora(d, h));
+                if (ventana > 0) {
+                    vector<int> conteos = ht.conteoPorVentanas(d, h, ventana);
+                    int largo = d <= h ? h - d + 1 : MINUTOS_DIA - d + h + 1;
+                    cout << "\nConteo por ventanas de " << ventana << " minutos:\n";
+                    for (size_t i = 0; i < conteos.size(); ++i) {
+                        int ini = static_cast<int>(i) * ventana;
+                        cout << "  " << minutosAHora(d + ini) << " - "
+                             << minutosAHora(d + min(ini + ventana, largo) - 1) << ": "
+                             << conteos[i] << endl;
+                    }
+                }
+                break;
+            }
+            case 23:
+                menuBenchmarks();
+                break;
+            case 24: {
+                string fuente;
+                int espera, tamLote;
+                cout << "Archivo o FIFO de eventos (V;... alta, B;id baja): ";
+                getline(cin, fuente);
+                cout << "Segundos sin datos antes de terminar (0 = leer hasta el final): ";
+                cin >> espera;
+                cout << "Eventos por lote: ";
+                cin >> tamLote;
+                ingerirStream(ht, fuente, max(espera, 0), max(tamLote, 1), &bitacora);
+                break;
+            }
+            case 25:
+                bitacora.compactar();
+                break;
+            case 26: {
+                GrafoCSR red = redParaConsultas(g, ordenCSR);
+                SimuladorTrafico sim(red);
+                mostrarSimulacion(red, sim.simular(vehiculosEnRed(red, ht.todos()),
+                                                   max(static_cast<int>(thread::hardware_concurrency()), 1)));
+                break;
+            }
+            case 27: {
+                string start, end, hora;
+                cout << "Nodo de inicio: ";
+                cin >> start;
+                cout << "Nodo de destino: ";
+                cin >> end;
+                cout << "Hora de salida (HH:MM): ";
+                cin >> hora;
+                
+                int s = g.getIdByName(start);
+                int e = g.getIdByName(end);
+                int salida = horaAMinutos(hora);
+                if (s == -1 || e == -1) {
+                    cout << "Error: Uno o ambos nodos no existen.\n";
+                    break;
+                }
+                if (salida == -1) {
+                    cout << "Error: Formato de hora invalido.\n";
+                    break;
+                }
+                
+                Ruta ruta = g.dijkstraDependiente(s, e, salida);
+                cout << "\n========== RUTA DEPENDIENTE DEL TIEMPO ==========\n";
+                if (ruta.camino.empty()) {
+                    cout << "No hay camino entre " << start << " y " << end << endl;
+                    break;
+                }
+                cout << "Salida: " << hora << "  Llegada: " 
+                     << minutosAHora(static_cast<int>(lround(salida + ruta.distancia))) << endl;
+                cout << "Tiempo de viaje: " << fixed << setprecision(2) << ruta.distancia << " minutos\n";
+                cout << "Camino: ";
+                for (size_t i = 0; i < ruta.camino.size(); ++i) {
+                    cout << g.getNameById(ruta.camino[i]);
+                    if (i < ruta.camino.size() - 1) cout << " -> ";
+                }
+                cout << endl;
+                break;
+            }
+            case 28: {
+                float capacidad;
+                int iteraciones;
+                double gapObjetivo;
+                string archivoCap;
+                cout << "Capacidad por arista (vehiculos): ";
+                cin >> capacidad;
+                cin.ignore();
+                cout << "Capacidades por tramo origen;destino;capacidad (Enter = ninguna): ";
+                getline(cin, archivoCap);
+                cout << "Iteraciones maximas: ";
+                cin >> iteraciones;
+                cout << "Gap relativo objetivo (p. ej. 0.001): ";
+                cin >> gapObjetivo;
+                
+                GrafoCSR red = redParaConsultas(g, ordenCSR);
+                AsignacionEquilibrio asig(red, capacidad, max(static_cast<int>(thread::hardware_concurrency()), 1));
+                int ignoradas = 0;
+                if (!archivoCap.empty()) {
+                    if (!asig.cargarCapacidades(archivoCap, ignoradas)) {
+                        cout << "Error: No se pudo abrir " << archivoCap << endl;
+                        break;
+                    }
+                    if (ignoradas > 0)
+                        cout << "Advertencia: " << ignoradas << " lineas de capacidad invalidas o de tramos inexistentes.\n";
+                }
+                asig.cargarDemanda(vehiculosEnRed(red, ht.todos()));
+                auto inicio = chrono::steady_clock::now();
+                asig.resolver(max(iteraciones, 1), gapObjetivo);
+                double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                mostrarAsignacion(red, asig, seg);
                 break;
+            }
+            case 29: {
+                string start, end, metodo;
+                int k;
+                cout << "Nodo de inicio: ";
+                cin >> start;
+                cout << "Nodo de destino: ";
+                cin >> end;
+                cout << "Numero de rutas: ";
+                cin >> k;
+                cout << "Metodo (Y = Yen, P = penalizacion): ";
+                cin >> metodo;
+                
+                int s = g.getIdByName(start);
+                int e = g.getIdByName(end);
+                if (s == -1 || e == -1) {
+                    cout << "Error: Uno o ambos nodos no existen.\n";
+                    break;
+                }
+                
+                GrafoCSR red = redParaConsultas(g, ordenCSR);
+                RutasAlternativas alt(red);
+                bool yen = metodo.empty() || metodo[0] == 'Y' || metodo[0] == 'y';
+                s = red.interno(s);
+                e = red.interno(e);
+                auto inicio = chrono::steady_clock::now();
+                vector<Ruta> rutas = yen ? alt.yen(s, e, k) : alt.penalizacion(s, e, k, 0.5f, 0.6f, 1.5f);
+                double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                
+                cout << "\n========== RUTAS ALTERNATIVAS (" << (yen ? "YEN" : "PENALIZACION") << ") ==========\n";
+                if (rutas.empty()) {
+                    cout << "No hay camino entre " << start << " y " << end << endl;
+                    break;
+                }
+                for (size_t i = 0; i < rutas.size(); ++i) {
+                    cout << i + 1 << ") " << fixed << setprecision(2) << rutas[i].distancia << ": ";
+                    for (size_t j = 0; j < rutas[i].camino.size(); ++j) {
+                        cout << red.nombres[rutas[i].camino[j]];
+                        if (j < rutas[i].camino.size() - 1) cout << " -> ";
+                    }
+                    cout << endl;
+                }
+                cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+                break;
+            }
+            case 30: {
+                string start, lista;
+                cout << "Nodo de inicio: ";
+                cin >> start;
+                cout << "Presupuestos separados por coma (p. ej. 4,8,12): ";
+                cin >> lista;
+                
+                int s = g.getIdByName(start);
+                if (s == -1) {
+                    cout << "Error: Nodo no encontrado.\n";
+                    break;
+                }
+                vector<float> presupuestos;
+                stringstream ss(lista);
+                string token;
+                try {
+                    while (getline(ss, token, ',')) presupuestos.push_back(stof(token));
+                } catch (const exception&) {
+                    presupuestos.clear();
+                }
+                if (presupuestos.empty() ||
+                    any_of(presupuestos.begin(), presupuestos.end(), [](float p) { return !(p >= 0); })) {
+                    cout << "Error: Presupuestos invalidos.\n";
+                    break;
+                }
+                sort(presupuestos.begin(), presupuestos.end());
+                
+                auto inicio = chrono::steady_clock::now();
+                vector<NodoAlcanzado> alcanzados = g.alcanzables(s, presupuestos);
+                double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                
+                cout << "\n========== ISOCRONA DESDE " << start << " ==========\n";
+                size_t i = 0;
+                for (size_t b = 0; b < presupuestos.size(); ++b) {
+                    cout << "<= " << fixed << setprecision(2) << presupuestos[b] << ": ";
+                    int enBanda = 0;
+                    for (; i < alcanzados.size() && alcanzados[i].banda == static_cast<int>(b); ++i, ++enBanda) {
+                        cout << g.getNameById(alcanzados[i].id) << "(" << alcanzados[i].distancia << ") ";
+                    }
+                    cout << "[" << enBanda << " nodos]\n";
+                }
+                cout << "Total alcanzados: " << alcanzados.size() << endl;
+                cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+                break;
+            }
+            case 31: {
+                string texto, modo;
+                cout << "Nombre o parte del nombre: ";
+                getline(cin, texto);
+                cout << "(P)refijo o (A)proximado: ";
+                cin >> modo;
+                
+                auto inicio = chrono::steady_clock::now();
+                cout << "\n========== BUSQUEDA DE NOMBRES ==========\n";
+                if (!modo.empty() && (modo[0] == 'A' || modo[0] == 'a')) {
+                    int maxDist = texto.size() <= 4 ? 1 : 2;
+                    auto res = g.buscarAproximado(texto, maxDist);
+                    for (const auto& r : res) {
+                        cout << g.getNameById(r.second) << " (" << r.second << "), distancia " << r.first << endl;
+                    }
+                    cout << "Coincidencias: " << res.size() << endl;
+                } else {
+                    auto res = g.buscarPorPrefijo(texto);
+                    for (int id : res) cout << g.getNameById(id) << " (" << id << ")\n";
+                    cout << "Coincidencias: " << res.size() << endl;
+                }
+                double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+                break;
+            }
+            case 32:
+                menuMetricas();
+                break;
+            case 33: {
+                Trazador& traza = Trazador::global();
+                if (!traza.activa()) {
+                    size_t limite;
+                    cout << "Maximo de eventos a registrar: ";
+                    cin >> limite;
+                    traza.iniciar(max<size_t>(limite, 1));
+                    cout << "Traza iniciada. Vuelva a elegir esta opcion para detenerla y guardarla.\n";
+                    break;
+                }
+                string archivo;
+                cout << "Archivo de traza (JSON de Chrome): ";
+                cin >> archivo;
+                traza.detener();
+                ofstream out(archivo);
+                if (!out.is_open()) {
+                    cout << "Error: No se pudo crear el archivo " << archivo << endl;
+                    break;
+                }
+                size_t escritos = traza.volcarJSON(out);
+                cout << "Traza guardada en " << archivo << ": " << escritos << " eventos";
+                if (traza.getDescartados() > 0) cout << " (" << traza.getDescartados() << " descartados por el limite)";
+                cout << endl;
+                break;
+            }
+            case 34: {
+                size_t antes = mostrarMemoria("RED", g.reporteMemoria());
+                antes += mostrarMemoria("VEHICULOS", ht.reporteMemoria());
+                string resp;
+                cout << "\nLiberar holgura? (s/n): ";
+                cin >> resp;
+                if (resp.empty() || (resp[0] != 's' && resp[0] != 'S')) break;
+                
+                g.liberarHolgura();
+                ht.liberarHolgura();
+                size_t despues = mostrarMemoria("RED", g.reporteMemoria());
+                despues += mostrarMemoria("VEHICULOS", ht.reporteMemoria());
+                cout << "\nMemoria liberada: " << fixed << setprecision(1)
+                     << (antes > despues ? antes - despues : 0) / 1024.0 << " KB\n";
+                break;
+            }
+            case 35: {
+                int modo;
+                cout << "Orden de nodos (0 = original, 1 = BFS, 2 = RCM, 3 = Hilbert): ";
+                cin >> modo;
+                if (modo < 0 || modo > 3) {
+                    cout << "Error: Orden invalido.\n";
+                    break;
+                }
+                ordenCSR = static_cast<OrdenNodos>(modo);
+                if (ordenCSR == OrdenNodos::Hilbert && !g.tieneCoordenadas()) {
+                    cout << "Advertencia: La red no tiene coordenadas; se usara el orden BFS.\n";
+                    ordenCSR = OrdenNodos::BFS;
+                }
+                
+                GrafoCSR original = GrafoCSR::desde(g);
+                LocalidadCSR antes = medirLocalidad(original);
+                LocalidadCSR despues = medirLocalidad(redParaConsultas(g, ordenCSR));
+                cout << "\n========== ORDEN DE NODOS: " << nombreOrden(ordenCSR) << " ==========\n";
+                cout << fixed << setprecision(2);
+                cout << "Distancia media entre vecinos: " << antes.distanciaMedia << " -> " << despues.distanciaMedia << endl;
+                cout << "Ancho de banda: " << antes.anchoBanda << " -> " << despues.anchoBanda << endl;
+                cout << "Se aplica a Simular, Equilibrio y RutasAlternas; los ids y nombres no cambian.\n";
+                break;
+            }
+            case 36: {
+                string start, end, resp;
+                cout << "Nodo de inicio: ";
+                cin >> start;
+                cout << "Nodo de destino: ";
+                cin >> end;
+                cout << "Cuantizar pesos a 16 bits? (s/n): ";
+                cin >> resp;
+                
+                int s = g.getIdByName(start);
+                int e = g.getIdByName(end);
+                if (s == -1 || e == -1) {
+                    cout << "Error: Uno o ambos nodos no existen.\n";
+                    break;
+                }
+                bool cuantizar = !resp.empty() && (resp[0] == 's' || resp[0] == 'S');
+                GrafoCSR red = redParaConsultas(g, ordenCSR);
+                GrafoComprimido comp = GrafoComprimido::desde(red, cuantizar);
+                
+                cout << "\n========== RUTA SOBRE ADYACENCIA COMPRIMIDA ==========\n";
+                cout << "Aristas: " << comp.getNumAristas() << "; CSR " << red.bytesAdyacencia()
+                     << " bytes, comprimida " << comp.bytes() << " bytes";
+                if (cuantizar) cout << " (escala " << scientific << setprecision(3) << comp.getEscala() << ")";
+                cout << endl;
+                
+                auto inicio = chrono::steady_clock::now();
+                Ruta ruta = comp.ruta(red.interno(s), red.interno(e));
+                double tiempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                if (ruta.camino.empty()) {
+                    cout << "No hay camino entre " << start << " y " << end << endl;
+                    break;
+                }
+                cout << "Distancia total: " << fixed << setprecision(2) << ruta.distancia << endl;
+                cout << "Camino: ";
+                for (size_t i = 0; i < ruta.camino.size(); ++i) {
+                    cout << red.nombres[ruta.camino[i]];
+                    if (i < ruta.camino.size() - 1) cout << " -> ";
+                }
+                cout << endl;
+                cout << "Tiempo de computo: " << scientific << tiempo << " segundos\n";
+                break;
+            }
+            case 37: {
+                string ruta;
+                int hilos;
+                cout << "Ruta del socket (p.ej. /tmp/trafico.sock): ";
+                getline(cin, ruta);
+                cout << "Hilos de trabajo: ";
+                cin >> hilos;
+                cin.ignore();
+                ServidorConsultas servidor(g, ht);
+                if (!servidor.abrir(ruta)) {
+                    cout << "Error: " << servidor.error << endl;
+                    break;
+                }
+                cout << "Servidor escuchando en " << ruta << " con " << max(hilos, 1)
+                     << " hilos (Enter o APAGAR para detener)...\n";
+                cout.flush();
+                EstadisticasServidor est = servidor.atender(max(hilos, 1), STDIN_FILENO);
+                if (est.paradaExterna) {
+                    string linea;
+                    getline(cin, linea);
+                }
+                cout << "\n========== SERVIDOR DETENIDO ==========\n";
+                cout << "Clientes atendidos: " << est.clientes << endl;
+                cout << "Solicitudes: " << est.solicitudes << " en " << est.lotes << " lotes (" << fixed << setprecision(1)
+                     << (est.lotes ? static_cast<double>(est.solicitudes) / est.lotes : 0.0) << " por lote)\n";
+                cout << "Rutas: " << est.rutas << " resueltas con " << est.arboles << " Dijkstra\n";
+                cout << "Tiempo activo: " << setprecision(3) << est.segundos << " segundos\n";
+                break;
+            }
+            case 38: {
+                int formato;
+                string archivo, extra;
+                cout << "Formato (1 = DIMACS .gr, 2 = lista de aristas OSM): ";
+                cin >> formato;
+                cin.ignore();
+                cout << "Archivo: ";
+                getline(cin, archivo);
+                if (formato == 1) cout << "Archivo de coordenadas .co (Enter = ninguno): ";
+                else cout << "Agregar tambien la arista inversa? (s/n): ";
+                getline(cin, extra);
+                
+                int antes = g.getNumNodos();
+                ImportadorRed imp(g);
+                auto inicio = chrono::steady_clock::now();
+                bool ok = formato == 1 ? imp.dimacs(archivo, extra)
+                                       : imp.osm(archivo, !extra.empty() && (extra[0] == 's' || extra[0] == 'S'));
+                if (!imp.advertencia.empty()) cout << "Advertencia: " << imp.advertencia << endl;
+                if (!ok) {
+                    cout << "Error: " << imp.error << endl;
+                    break;
+                }
+                double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                cout << "\n========== IMPORTACION ==========\n";
+                cout << "Nodos nuevos: " << g.getNumNodos() - antes << ", aristas: " << imp.arcos - imp.descartadas
+                     << " (descartadas: " << imp.descartadas << ")\n";
+                cout << "Lineas leidas: " << imp.lineas << ", invalidas: " << imp.invalidas << endl;
+                cout << "Tiempo: " << fixed << setprecision(3) << seg << " segundos\n";
+                bitacora.compactar();
+                break;
+            }
+            case 39: {
+                int reporte, formato, s = -1;
+                long long desde, hasta;
+                size_t porPagina, pagina = 1;
+                string archivo;
+                cout << "Reporte (1 = lista de adyacencia, 2 = BFS, 3 = DFS): ";
+                cin >> reporte;
+                if (reporte < 1 || reporte > 3) {
+                    cout << "Error: Reporte invalido.\n";
+                    break;
+                }
+                if (reporte != 1) {
+                    string start;
+                    cout << "Nodo de inicio: ";
+                    cin >> start;
+                    s = g.getIdByName(start);
+                    if (s == -1) {
+                        cout << "Error: Nodo no encontrado.\n";
+                        break;
+                    }
+                }
+                cout << "Formato (1 = texto, 2 = CSV, 3 = JSON): ";
+                cin >> formato;
+                cout << "Rango de IDs (desde hasta, -1 -1 = todos): ";
+                cin >> desde >> hasta;
+                cout << "Filas por pagina (0 = todas): ";
+                cin >> porPagina;
+                if (porPagina > 0) {
+                    cout << "Pagina (desde 1): ";
+                    cin >> pagina;
+                }
+                cin.ignore();
+                cout << "Archivo de salida (- = pantalla): ";
+                getline(cin, archivo);
+                if (!cin || archivo.empty() || pagina == 0) {
+                    cout << "Error: Datos invalidos.\n";
+                    break;
+                }
+                
+                FiltroReporte filtro;
+                if (desde >= 0) filtro.desde = static_cast<int>(min<long long>(desde, numeric_limits<int>::max()));
+                if (hasta >= 0) filtro.hasta = static_cast<int>(min<long long>(hasta, numeric_limits<int>::max()));
+                filtro.porPagina = porPagina;
+                filtro.pagina = pagina - 1;
+                exportarReporte(g, reporte, s,
+                                formato == 2 ? FormatoReporte::CSV
+                                : formato == 3 ? FormatoReporte::JSON : FormatoReporte::Texto,
+                                filtro, archivo);
+                break;
+            }
             case 0: 
                 cout << "\nCerrando simulador...\n"; 
                 cout << "Gracias por usar el sistema!\n";
@@ -0,0 +1,893 @@
+#include "benchmarks.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace trafico {
+
+void mostrarAsignacion(const GrafoCSR& red, const AsignacionEquilibrio& asig, double segundos) {
+    cout << "\n========== ASIGNACION EN EQUILIBRIO (FRANK-WOLFE) ==========\n";
+    cout << setw(6) << "Iter" << setw(14) << "Gap relativo" << setw(10) << "Paso" 
+         << setw(18) << "Tiempo total" << endl;
+    cout << string(48, '-') << endl;
+    for (const auto& it : asig.historial) {
+        cout << setw(6) << it.numero << setw(14) << scientific << setprecision(3) << it.gap 
+             << setw(10) << fixed << setprecision(4) << it.paso 
+             << setw(18) << setprecision(1) << it.tiempoTotal << endl;
+    }
+
+    vector<int> orden(asig.flujo.size());
+    for (size_t k = 0; k < orden.size(); ++k) orden[k] = static_cast<int>(k);
+    size_t top = min<size_t>(10, orden.size());
+    partial_sort(orden.begin(), orden.begin() + top, orden.end(), [&](int a, int b) {
+        return asig.flujo[a] > asig.flujo[b];
+    });
+    cout << "\nTramos con mayor flujo:\n";
+    cout << setw(30) << "Tramo" << setw(10) << "Flujo" << setw(8) << "v/c" 
+         << setw(10) << "t libre" << setw(10) << "t equil." << endl;
+    cout << string(68, '-') << endl;
+    for (size_t i = 0; i < top && asig.flujo[orden[i]] > 0; ++i) {
+        int k = orden[i];
+        cout << setw(30) << (red.nombres[red.origenDe(k)] + " -> " + red.nombres[red.destino[k]])
+             << setw(10) << setprecision(1) << asig.flujo[k] 
+             << setw(8) << setprecision(2) << asig.flujo[k] / asig.getCapacidad(k)
+             << setw(10) << red.peso[k] << setw(10) << asig.tiempoActual(k) << endl;
+    }
+    cout << "\nTiempo de computo: " << setprecision(3) << segundos << " segundos\n";
+}
+
+void mostrarSimulacion(const GrafoCSR& red, const ResultadoSimulacion& res) {
+    cout << "\n========== SIMULACION DE TRAFICO ==========\n";
+    cout << "Vehiculos: " << res.vehiculos << " (completados: " << res.completados
+         << ", sin ruta o datos invalidos: " << res.sinRuta << ")\n";
+    cout << "Eventos procesados: " << res.eventos << endl;
+    cout << "Tiempo medio de viaje: " << fixed << setprecision(2) << res.viajeMedioMin << " minutos\n";
+    cout << "Ultima llegada: dia " << res.ultimaLlegada / 86400 + 1 << ", "
+         << minutosAHora(res.ultimaLlegada / 60) << endl;
+    cout << "Calculo de rutas: " << setprecision(3) << res.segundosRutas << " s ("
+         << res.destinosDistintos << " destinos distintos)\n";
+    cout << "Simulacion: " << res.segundosSimulacion << " s";
+    if (res.segundosSimulacion > 0) {
+        cout << " (" << setprecision(0) << res.eventos / res.segundosSimulacion << " eventos/seg)";
+    }
+    cout << endl;
+
+    vector<int> orden(res.ocupacionMaxima.size());
+    for (size_t k = 0; k < orden.size(); ++k) orden[k] = static_cast<int>(k);
+    size_t top = min<size_t>(10, orden.size());
+    partial_sort(orden.begin(), orden.begin() + top, orden.end(), [&](int a, int b) {
+        return res.ocupacionMaxima[a] > res.ocupacionMaxima[b];
+    });
+    cout << "\nTramos con mayor ocupacion simultanea:\n";
+    cout << setw(30) << "Tramo" << setw(12) << "Ocup. max" << setw(12) << "Pasadas" << endl;
+    cout << string(54, '-') << endl;
+    for (size_t i = 0; i < top && res.ocupacionMaxima[orden[i]] > 0; ++i) {
+        int k = orden[i];
+        cout << setw(30) << (red.nombres[red.origenDe(k)] + " -> " + red.nombres[red.destino[k]])
+             << setw(12) << res.ocupacionMaxima[k] << setw(12) << res.pasadas[k] << endl;
+    }
+}
+
+void benchmarkSimulacion(int lado, int numVehiculos, int zonas, int hilos) {
+    Grafo g;
+    generarRejilla(g, lado, 11);
+    GrafoCSR red = GrafoCSR::desde(g);
+
+    mt19937 rng(2024);
+    uniform_int_distribution<int> nodoDist(0, red.numNodos - 1);
+    vector<int> nodosZona(max(zonas, 1));
+    for (int& z : nodosZona) z = nodoDist(rng);
+    uniform_int_distribution<int> zonaDist(0, static_cast<int>(nodosZona.size()) - 1);
+    normal_distribution<double> pico(8 * 60, 90);
+    uniform_int_distribution<int> diaDist(0, MINUTOS_DIA - 1);
+
+    vector<Vehiculo> vehiculos(numVehiculos);
+    for (int i = 0; i < numVehiculos; ++i) {
+        Vehiculo& v = vehiculos[i];
+        v.id = "S" + to_string(i);
+        v.tipo = "Particular";
+        v.origen = nodosZona[zonaDist(rng)];
+        v.destino = nodosZona[zonaDist(rng)];
+        int minuto = (i % 2 == 0) ? static_cast<int>(pico(rng)) : diaDist(rng);
+        v.horaEntrada = minutosAHora(minuto);
+    }
+
+    cout << "\nRed: " << red.numNodos << " nodos, " << red.numAristas() << " aristas; "
+         << numVehiculos << " vehiculos entre " << nodosZona.size() << " zonas; " << hilos << " hilos\n";
+    SimuladorTrafico sim(red);
+    auto inicio = chrono::steady_clock::now();
+    ResultadoSimulacion res = sim.simular(vehiculos, hilos);
+    double total = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    mostrarSimulacion(red, res);
+    cout << "\nTiempo total del benchmark: " << fixed << setprecision(3) << total << " s\n";
+}
+
+void benchmarkAsignacion(int lado, int numVehiculos, int zonas, int iteraciones) {
+    Grafo g;
+    generarRejilla(g, lado, 13);
+    GrafoCSR red = GrafoCSR::desde(g);
+
+    mt19937 rng(77);
+    uniform_int_distribution<int> nodoDist(0, red.numNodos - 1);
+    vector<int> nodosZona(max(zonas, 1));
+    for (int& z : nodosZona) z = nodoDist(rng);
+    uniform_int_distribution<int> zonaDist(0, static_cast<int>(nodosZona.size()) - 1);
+    vector<Vehiculo> vehiculos(numVehiculos);
+    for (auto& v : vehiculos) {
+        v.origen = nodosZona[zonaDist(rng)];
+        v.destino = nodosZona[zonaDist(rng)];
+    }
+
+    cout << "\n========== BENCHMARK ASIGNACION EN EQUILIBRIO ==========\n";
+    cout << "Red: " << red.numNodos << " nodos; " << numVehiculos << " viajes entre " 
+         << nodosZona.size() << " zonas; " << iteraciones << " iteraciones\n";
+    cout << setw(8) << "Hilos" << setw(14) << "Segundos" << setw(12) << "Speedup" << setw(14) << "Gap final" << endl;
+    cout << string(48, '-') << endl;
+
+    int maxHilos = max(static_cast<int>(thread::hardware_concurrency()), 1);
+    double base = 0;
+    for (int hilos = 1; hilos <= maxHilos; hilos *= 2) {
+        AsignacionEquilibrio asig(red, numVehiculos / 200.0f, hilos);
+        asig.cargarDemanda(vehiculos);
+        auto inicio = chrono::steady_clock::now();
+        asig.resolver(iteraciones, 0);
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (hilos == 1) base = seg;
+        cout << setw(8) << hilos << setw(14) << fixed << setprecision(3) << seg 
+             << setw(11) << setprecision(2) << base / seg << "x" 
+             << setw(14) << scientific << setprecision(3) << asig.historial.back().gap << fixed << endl;
+    }
+}
+
+void benchmarkAlternativas(int lado, int consultas, int k) {
+    Grafo g;
+    generarRejilla(g, lado, 17);
+    GrafoCSR red = GrafoCSR::desde(g);
+    RutasAlternativas alt(red);
+    mt19937 rng(5);
+    uniform_int_distribution<int> nodoDist(0, red.numNodos - 1);
+    vector<pair<int, int>> pares(consultas);
+    for (auto& p : pares) p = {nodoDist(rng), nodoDist(rng)};
+
+    cout << "\n========== BENCHMARK RUTAS ALTERNATIVAS ==========\n";
+    cout << "Red: " << red.numNodos << " nodos; " << consultas << " consultas; k = " << k << endl;
+    for (int metodo = 0; metodo < 2; ++metodo) {
+        long rutas = 0;
+        auto inicio = chrono::steady_clock::now();
+        for (const auto& p : pares) {
+            rutas += metodo == 0 ? alt.yen(p.first, p.second, k).size()
+                                 : alt.penalizacion(p.first, p.second, k, 0.5f, 0.6f, 1.5f).size();
+        }
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        cout << (metodo == 0 ? "Yen:          " : "Penalizacion: ") << fixed << setprecision(3)
+             << 1000.0 * seg / consultas << " ms/consulta, " << setprecision(2)
+             << static_cast<double>(rutas) / consultas << " rutas/consulta\n";
+    }
+}
+
+void benchmarkReordenamiento(int lado, int consultas) {
+    Grafo g;
+    generarRejilla(g, lado, 23);
+    GrafoCSR base = GrafoCSR::desde(g);
+    mt19937 rng(9);
+    vector<int> azar(base.numNodos);
+    for (int i = 0; i < base.numNodos; ++i) azar[i] = i;
+    shuffle(azar.begin(), azar.end(), rng);
+    GrafoCSR desordenada = base.permutado(azar);
+
+    uniform_int_distribution<int> nodoDist(0, base.numNodos - 1);
+    vector<int> origenes(consultas);
+    for (int& o : origenes) o = nodoDist(rng);
+
+    cout << "\n========== BENCHMARK REORDENAMIENTO ==========\n";
+    cout << "Red: " << base.numNodos << " nodos, " << base.numAristas() << " aristas; "
+         << consultas << " arboles de Dijkstra y " << consultas << " BFS por orden\n";
+    cout << left << setw(12) << "Orden" << right << setw(14) << "Dist. media" << setw(14) << "Ancho banda"
+         << setw(16) << "Dijkstra (ms)" << setw(12) << "BFS (ms)" << endl;
+
+    vector<float> dist;
+    vector<int> pred, cola;
+    vector<char> visto;
+    for (OrdenNodos modo : {OrdenNodos::Original, OrdenNodos::BFS, OrdenNodos::RCM, OrdenNodos::Hilbert}) {
+        GrafoCSR red = modo == OrdenNodos::Original ? desordenada
+                                                    : desordenada.permutado(calcularOrden(desordenada, modo));
+        LocalidadCSR loc = medirLocalidad(red);
+
+        auto inicio = chrono::steady_clock::now();
+        for (int o : origenes) red.arbolDesde(red.interno(o), nullptr, dist, pred);
+        double segDijkstra = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        long alcanzados = 0;
+        inicio = chrono::steady_clock::now();
+        for (int o : origenes) {
+            visto.assign(red.numNodos, 0);
+            cola.clear();
+            int s = red.interno(o);
+            visto[s] = 1;
+            cola.push_back(s);
+            for (size_t c = 0; c < cola.size(); ++c) {
+                int u = cola[c];
+                for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+                    int v = red.destino[k];
+                    if (!visto[v]) {
+                        visto[v] = 1;
+                        cola.push_back(v);
+                    }
+                }
+            }
+            alcanzados += static_cast<long>(cola.size());
+        }
+        double segBFS = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        cout << left << setw(12) << (modo == OrdenNodos::Original ? "Aleatorio" : nombreOrden(modo)) << right
+             << fixed << setprecision(1) << setw(14) << loc.distanciaMedia << setw(14) << loc.anchoBanda
+             << setprecision(3) << setw(16) << 1000.0 * segDijkstra / consultas
+             << setw(12) << 1000.0 * segBFS / consultas << endl;
+        if (alcanzados != static_cast<long>(consultas) * red.numNodos) {
+            cout << "Advertencia: el BFS no alcanzo todos los nodos con este orden.\n";
+        }
+    }
+    cout << left;
+}
+
+void benchmarkRelajacion(int lado, int hubs, int gradoHub, int consultas) {
+    Grafo g;
+    generarRejilla(g, lado, 29);
+    int n = lado * lado;
+    mt19937 rng(31);
+    uniform_int_distribution<int> nodoDist(0, n - 1);
+    uniform_real_distribution<float> peso(5.0f, 20.0f);
+    for (int h = 0; h < hubs; ++h) {
+        int c = nodoDist(rng);
+        for (int i = 0; i < gradoHub; ++i) {
+            int v = nodoDist(rng);
+            if (v == c) continue;
+            g.altaArista(c, v, peso(rng));
+            g.altaArista(v, c, peso(rng));
+        }
+    }
+    GrafoCSR red = GrafoCSR::desde(g);
+    vector<int> origenes(consultas);
+    for (int& o : origenes) o = nodoDist(rng);
+
+    cout << "\n========== BENCHMARK RELAJACION SIMD ==========\n";
+    cout << "Red: " << red.numNodos << " nodos, " << red.numAristas() << " aristas, "
+         << hubs << " hubs de grado ~" << 2 * gradoHub << "; " << consultas << " arboles\n";
+
+    KernelRelajacion previo = kernelRelajacion().load();
+    vector<float> dist, referencia;
+    vector<int> pred;
+    double segEscalar = 0;
+    for (const auto& var : variantesRelajacion()) {
+        if (!var.disponible) {
+            cout << setw(10) << var.nombre << ": no soportada por esta CPU\n";
+            continue;
+        }
+        kernelRelajacion().store(var.kernel);
+        bool iguales = true;
+        auto inicio = chrono::steady_clock::now();
+        for (size_t i = 0; i < origenes.size(); ++i) {
+            red.arbolDesde(origenes[i], nullptr, dist, pred);
+            if (i == 0) {
+                if (referencia.empty()) referencia = dist;
+                iguales = dist == referencia;
+            }
+        }
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (segEscalar == 0) segEscalar = seg;
+        cout << setw(10) << var.nombre << ": " << fixed << setprecision(3) << 1000.0 * seg / consultas
+             << " ms/arbol (x" << setprecision(2) << segEscalar / seg << ")"
+             << (var.kernel == previo ? " [en uso]" : "") << (iguales ? "" : " DISTANCIAS DISTINTAS") << endl;
+    }
+    kernelRelajacion().store(previo);
+}
+
+void benchmarkCompresion(int lado, int consultas) {
+    Grafo g;
+    generarRejilla(g, lado, 37);
+    size_t bytesGrafo = 0;
+    for (const auto& u : g.reporteMemoria()) {
+        if (u.componente == "Nodos" || u.componente == "Adyacencia (pool)") bytesGrafo += u.vivos + u.holgura;
+    }
+    GrafoCSR red = GrafoCSR::desde(g);
+    GrafoComprimido exacto = GrafoComprimido::desde(red, false);
+    GrafoComprimido cuantizado = GrafoComprimido::desde(red, true);
+
+    mt19937 rng(41);
+    uniform_int_distribution<int> nodoDist(0, red.numNodos - 1);
+    vector<pair<int, int>> pares(consultas);
+    for (auto& p : pares) p = {nodoDist(rng), nodoDist(rng)};
+
+    cout << "\n========== BENCHMARK ADYACENCIA COMPRIMIDA ==========\n";
+    cout << "Red: " << red.numNodos << " nodos, " << red.numAristas() << " aristas; " << consultas << " rutas\n";
+    cout << left << setw(22) << "Estructura" << right << setw(12) << "KB" << setw(10) << "B/arista"
+         << setw(10) << "Factor" << setw(14) << "ms/ruta" << setw(14) << "Error max" << endl;
+
+    vector<float> referencia(consultas);
+    auto fila = [&](const char* nombre, size_t bytes, double seg, double error) {
+        cout << left << setw(22) << nombre << right << fixed << setprecision(1) << setw(12) << bytes / 1024.0
+             << setprecision(2) << setw(10) << static_cast<double>(bytes) / red.numAristas()
+             << setw(10) << static_cast<double>(bytesGrafo) / bytes
+             << setprecision(3) << setw(14) << 1000.0 * seg / consultas
+             << setprecision(5) << setw(14) << error << endl;
+    };
+    // Sin perfiles, la ruta dependiente del tiempo es el Dijkstra sobre las listas
+    auto inicio = chrono::steady_clock::now();
+    for (int i = 0; i < consultas; ++i) referencia[i] = g.dijkstraDependiente(pares[i].first, pares[i].second, 0).distancia;
+    fila("Grafo (listas)", bytesGrafo, chrono::duration<double>(chrono::steady_clock::now() - inicio).count(), 0);
+
+    vector<float> dist;
+    vector<int> pred;
+    inicio = chrono::steady_clock::now();
+    for (int i = 0; i < consultas; ++i) {
+        red.arbolDesde(pares[i].first, nullptr, dist, pred, pares[i].second);
+        referencia[i] = dist[pares[i].second];
+    }
+    fila("CSR", red.bytesAdyacencia(), chrono::duration<double>(chrono::steady_clock::now() - inicio).count(), 0);
+
+    for (const GrafoComprimido* c : {&exacto, &cuantizado}) {
+        double errorMax = 0;
+        inicio = chrono::steady_clock::now();
+        vector<float> obtenidas(consultas);
+        for (int i = 0; i < consultas; ++i) obtenidas[i] = c->ruta(pares[i].first, pares[i].second).distancia;
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        for (int i = 0; i < consultas; ++i) {
+            if (referencia[i] > 0) errorMax = max(errorMax, fabs(static_cast<double>(obtenidas[i]) - referencia[i]) / referencia[i]);
+        }
+        fila(c->esCuantizado() ? "Comprimido (16 bits)" : "Comprimido (float)", c->bytes(), seg, errorMax);
+    }
+    cout << left;
+    cout << "Factor: tamano de las listas del Grafo / tamano de la estructura. "
+         << "Error: relativo sobre la distancia de la ruta.\n";
+}
+
+void generarEscenario(int tipo, mt19937& rng, Grafo& g, EscenarioPrueba& esc) {
+    static const char* const NOMBRES[] = {"aleatoria", "pesos cero", "paralelas y lazos", "desconectada",
+                                          "nodos borrados", "concentradores", "rejilla con empates"};
+    esc.nombre = NOMBRES[tipo];
+    int n = tipo == 6 ? 400 : uniform_int_distribution<int>(150, 500)(rng);
+    esc.numNodos = n;
+    esc.existe.assign(n, true);
+    esc.ady.assign(n, {});
+
+    // Los huecos son IDs que nunca se dan de alta
+    if (tipo == 4) {
+        for (int u = 0; u < n; ++u) esc.existe[u] = rng() % 20 != 0;
+        esc.existe[n - 1] = true;
+    }
+    uniform_real_distribution<float> coord(0, 1000);
+    for (int u = 0; u < n; ++u) {
+        if (!esc.existe[u]) continue;
+        g.altaNodo(u, "p" + to_string(u));
+        g.fijarCoordenadas(u, coord(rng), coord(rng));
+    }
+
+    auto arista = [&](int u, int v, float w) {
+        if (!esc.existe[u] || !esc.existe[v]) return;
+        g.altaArista(u, v, w);
+        esc.ady[u].push_back({v, w});
+    };
+    uniform_int_distribution<int> nodo(0, n - 1);
+    uniform_real_distribution<float> peso(0, 10);
+    int m = 4 * n;
+    switch (tipo) {
+        case 1:
+            for (int i = 0; i < m; ++i) arista(nodo(rng), nodo(rng), rng() % 5 < 2 ? 0.0f : static_cast<float>(rng() % 4));
+            break;
+        case 2:
+            for (int i = 0; i < m / 2; ++i) {
+                int u = nodo(rng), v = rng() % 10 == 0 ? u : nodo(rng);
+                for (int k = 1 + rng() % 3; k > 0; --k) arista(u, v, peso(rng));
+            }
+            break;
+        case 3: {
+            // Cuatro bloques sin aristas entre si, salvo unos pocos puentes de un sentido
+            const int PARTES = 4;
+            int tam = n / PARTES;
+            for (int i = 0; i < m; ++i) {
+                int p = rng() % PARTES;
+                int u = p * tam + rng() % tam, v = p * tam + rng() % tam;
+                arista(u, v, peso(rng));
+            }
+            for (int i = 0; i < 2; ++i) arista(nodo(rng), nodo(rng), peso(rng));
+            break;
+        }
+        case 5: {
+            // Pocos nodos de grado alto (camino SIMD) y pesos de magnitudes muy distintas
+            uniform_real_distribution<float> exponente(-3, 4);
+            auto pesoAmplio = [&]() { return pow(10.0f, exponente(rng)); };
+            for (int h = 0; h < 6; ++h) {
+                int hub = nodo(rng);
+                for (int k = 40 + rng() % 160; k > 0; --k) {
+                    arista(hub, nodo(rng), pesoAmplio());
+                    arista(nodo(rng), hub, pesoAmplio());
+                }
+            }
+            for (int i = 0; i < m / 2; ++i) arista(nodo(rng), nodo(rng), pesoAmplio());
+            break;
+        }
+        case 6: {
+            int lado = 20;
+            for (int f = 0; f < lado; ++f) {
+                for (int c = 0; c < lado; ++c) {
+                    int u = f * lado + c;
+                    if (c + 1 < lado) { arista(u, u + 1, 1); arista(u + 1, u, 1); }
+                    if (f + 1 < lado) { arista(u, u + lado, 1); arista(u + lado, u, 1); }
+                }
+            }
+            break;
+        }
+        default:
+            for (int i = 0; i < m; ++i) arista(nodo(rng), nodo(rng), peso(rng));
+            break;
+    }
+
+    if (tipo == 4) {
+        for (int u = 0; u < n - 1; ++u) {
+            if (!esc.existe[u] || rng() % 10 != 0) continue;
+            g.bajaNodo(u);
+            esc.existe[u] = false;
+        }
+        for (int u = 0; u < n; ++u) {
+            auto& adj = esc.ady[u];
+            if (!esc.existe[u]) adj.clear();
+            adj.erase(remove_if(adj.begin(), adj.end(), [&](const pair<int, float>& a) { return !esc.existe[a.first]; }),
+                      adj.end());
+        }
+    }
+    g.reconstruirIndiceNombres();
+}
+
+void distanciasReferencia(const EscenarioPrueba& esc, int s, vector<double>& dist, vector<int>& saltos) {
+    const double INF = numeric_limits<double>::infinity();
+    int n = esc.numNodos;
+    dist.assign(n, INF);
+    saltos.assign(n, 0);
+    vector<bool> fijo(n, false);
+    dist[s] = 0;
+    for (int iter = 0; iter < n; ++iter) {
+        int u = -1;
+        for (int v = 0; v < n; ++v) {
+            if (!fijo[v] && dist[v] != INF && (u == -1 || dist[v] < dist[u])) u = v;
+        }
+        if (u == -1) break;
+        fijo[u] = true;
+        for (const auto& [v, w] : esc.ady[u]) {
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                saltos[v] = saltos[u] + 1;
+            }
+        }
+    }
+}
+
+bool pruebaDiferencial(int rondas, unsigned semilla) {
+    const float INF = numeric_limits<float>::infinity();
+    const int NUM_ESCENARIOS = 7;
+    const int ORIGENES = 6;
+    const int DESTINOS = 12;
+    const size_t MAX_DETALLES = 10;
+
+    mt19937 rng(semilla);
+    vector<MotorPrueba> motores;
+    vector<string> detalles;
+    KernelRelajacion kernelOriginal = kernelRelajacion().load();
+
+    auto motor = [&](const string& nombre) -> MotorPrueba& {
+        for (auto& m : motores) if (m.nombre == nombre) return m;
+        motores.push_back({nombre});
+        return motores.back();
+    };
+    auto cronometrar = [](MotorPrueba& m, auto&& f) {
+        auto inicio = chrono::steady_clock::now();
+        f();
+        m.segundos += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    };
+
+    cout << "\n========== PRUEBA DIFERENCIAL DE MOTORES ==========\n";
+    cout << "Escenarios: " << NUM_ESCENARIOS << " x " << rondas << " rondas, semilla " << semilla << endl;
+
+    for (int ronda = 0; ronda < rondas; ++ronda) {
+        for (int tipo = 0; tipo < NUM_ESCENARIOS; ++tipo) {
+            Grafo g;
+            EscenarioPrueba esc;
+            generarEscenario(tipo, rng, g, esc);
+            int n = esc.numNodos;
+
+            // Peso minimo entre cada par de nodos, para validar los caminos
+            unordered_map<long long, float> pesoMin;
+            for (int u = 0; u < n; ++u) {
+                for (const auto& [v, w] : esc.ady[u]) {
+                    long long k = static_cast<long long>(u) * n + v;
+                    auto it = pesoMin.find(k);
+                    if (it == pesoMin.end() || w < it->second) pesoMin[k] = w;
+                }
+            }
+
+            GrafoCSR csr = GrafoCSR::desde(g);
+            vector<pair<string, GrafoCSR>> ordenes;
+            for (OrdenNodos o : {OrdenNodos::BFS, OrdenNodos::RCM, OrdenNodos::Hilbert}) {
+                ordenes.push_back({string("CSR orden ") + nombreOrden(o), redParaConsultas(g, o)});
+            }
+            GrafoComprimido compFloat = GrafoComprimido::desde(csr, false);
+            GrafoComprimido comp16 = GrafoComprimido::desde(csr, true);
+            GrafoVersionado gv;
+            gv.reconstruir(g);
+            auto version = gv.fijar();
+            RutasAlternativas alternas(csr);
+
+            vector<int> existentes;
+            for (int u = 0; u < n; ++u) if (esc.existe[u]) existentes.push_back(u);
+
+            vector<double> ref;
+            vector<int> saltos;
+            for (int q = 0; q < ORIGENES; ++q) {
+                int s = existentes[rng() % existentes.size()];
+                distanciasReferencia(esc, s, ref, saltos);
+                // Los destinos incluyen nodos borrados, huecos e inalcanzables
+                vector<int> destinos;
+                for (int k = 0; k < DESTINOS; ++k) destinos.push_back(rng() % n);
+
+                auto comparar = [&](MotorPrueba& m, int t, float obtenido, double tolExtra) {
+                    m.consultas++;
+                    double esperado = ref[t];
+                    bool ok = (esperado == numeric_limits<double>::infinity() || obtenido == INF)
+                        ? (esperado == numeric_limits<double>::infinity() && obtenido == INF)
+                        : fabs(obtenido - esperado) <= 1e-4 * max(1.0, esperado) + tolExtra;
+                    if (ok) return;
+                    m.discrepancias++;
+                    if (detalles.size() < MAX_DETALLES) {
+                        ostringstream out;
+                        out << "  [" << m.nombre << "] " << esc.nombre << " " << s << " -> " << t
+                            << ": esperado " << esperado << ", obtenido " << obtenido;
+                        detalles.push_back(out.str());
+                    }
+                };
+                // Un camino valido va de s a t por aristas existentes y suma su distancia
+                auto validarCamino = [&](MotorPrueba& m, int t, const Ruta& r) {
+                    if (r.camino.empty()) return;
+                    double suma = 0;
+                    bool ok = r.camino.front() == s && r.camino.back() == t;
+                    for (size_t i = 0; ok && i + 1 < r.camino.size(); ++i) {
+                        auto it = pesoMin.find(static_cast<long long>(r.camino[i]) * n + r.camino[i + 1]);
+                        if (it == pesoMin.end()) ok = false;
+                        else suma += it->second;
+                    }
+                    if (ok && fabs(suma - r.distancia) <= 1e-4 * max(1.0, suma)) return;
+                    m.discrepancias++;
+                    if (detalles.size() < MAX_DETALLES) {
+                        detalles.push_back("  [" + m.nombre + "] " + esc.nombre + " " + to_string(s) + " -> "
+                                           + to_string(t) + ": camino invalido");
+                    }
+                };
+                auto porPares = [&](const string& nombre, double tolPorSalto, auto&& resolver) {
+                    MotorPrueba& m = motor(nombre);
+                    vector<Ruta> rutas;
+                    cronometrar(m, [&]() { for (int t : destinos) rutas.push_back(resolver(t)); });
+                    for (size_t k = 0; k < destinos.size(); ++k) {
+                        int t = destinos[k];
+                        double hops = max<double>(saltos[t], rutas[k].camino.size());
+                        comparar(m, t, rutas[k].distancia, tolPorSalto * hops);
+                        if (tolPorSalto == 0) validarCamino(m, t, rutas[k]);
+                    }
+                };
+                auto arbolCSR = [&](const string& nombre, const GrafoCSR& red) {
+                    MotorPrueba& m = motor(nombre);
+                    vector<float> dist;
+                    vector<int> pred;
+                    cronometrar(m, [&]() { red.arbolDesde(red.interno(s), nullptr, dist, pred); });
+                    for (int t = 0; t < n; ++t) {
+                        int ti = red.interno(t);
+                        comparar(m, t, ti >= 0 ? dist[ti] : INF, 0);
+                    }
+                };
+
+                porPares("Grafo::rutaMasCorta", 0, [&](int t) { return g.rutaMasCorta(s, t); });
+                porPares("Grafo::dijkstraDependiente", 0, [&](int t) { return g.dijkstraDependiente(s, t, 0); });
+                porPares("VersionGrafo::dijkstra", 0, [&](int t) { return version->dijkstra(s, t); });
+                porPares("GrafoComprimido float", 0, [&](int t) { return compFloat.ruta(s, t); });
+                porPares("GrafoComprimido 16 bits", comp16.getEscala() / 2, [&](int t) { return comp16.ruta(s, t); });
+                porPares("Yen k=1", 0, [&](int t) {
+                    vector<Ruta> rs = alternas.yen(s, t, 1);
+                    return rs.empty() ? Ruta{INF, {}} : rs[0];
+                });
+                {
+                    MotorPrueba& m = motor("VersionGrafo::rutasDesde");
+                    vector<Ruta> rutas;
+                    cronometrar(m, [&]() { rutas = version->rutasDesde(s, destinos); });
+                    for (size_t k = 0; k < destinos.size(); ++k) {
+                        comparar(m, destinos[k], rutas[k].distancia, 0);
+                        validarCamino(m, destinos[k], rutas[k]);
+                    }
+                }
+                {
+                    MotorPrueba& m = motor("Grafo::alcanzables");
+                    vector<NodoAlcanzado> alc;
+                    cronometrar(m, [&]() { alc = g.alcanzables(s, numeric_limits<float>::max()); });
+                    vector<float> dist(n, INF);
+                    for (const auto& a : alc) dist[a.id] = a.distancia;
+                    for (int t = 0; t < n; ++t) comparar(m, t, dist[t], 0);
+                }
+                for (const auto& v : variantesRelajacion()) {
+                    if (!v.disponible) continue;
+                    kernelRelajacion().store(v.kernel);
+                    arbolCSR(string("CSR kernel ") + v.nombre, csr);
+                }
+                kernelRelajacion().store(kernelOriginal);
+                for (const auto& [nombre, red] : ordenes) arbolCSR(nombre, red);
+
+                // Recorridos: mismo conjunto de nodos alcanzados que la referencia
+                for (bool anchura : {true, false}) {
+                    MotorPrueba& m = motor(anchura ? "VersionGrafo BFS" : "VersionGrafo DFS");
+                    vector<int> orden;
+                    cronometrar(m, [&]() { orden = version->recorrido(s, anchura); });
+                    vector<bool> visto(n, false);
+                    bool ok = true;
+                    for (int u : orden) {
+                        if (visto[u]) ok = false;
+                        visto[u] = true;
+                    }
+                    for (int t = 0; t < n; ++t) ok = ok && visto[t] == (ref[t] != numeric_limits<double>::infinity());
+                    m.consultas++;
+                    if (!ok) {
+                        m.discrepancias++;
+                        if (detalles.size() < MAX_DETALLES) {
+                            detalles.push_back("  [" + m.nombre + "] " + esc.nombre + " desde " + to_string(s)
+                                               + ": conjunto alcanzado distinto");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    cout << "\n" << left << setw(30) << "Motor" << right << setw(10) << "Consultas" << setw(14) << "Discrepancias"
+         << setw(12) << "ms totales" << "\n";
+    cout << string(66, '-') << "\n";
+    long total = 0;
+    for (const auto& m : motores) {
+        cout << left << setw(30) << m.nombre << right << setw(10) << m.consultas << setw(14) << m.discrepancias
+             << setw(12) << fixed << setprecision(2) << m.segundos * 1000 << "\n";
+        total += m.discrepancias;
+    }
+    if (total == 0) {
+        cout << "\nTodos los motores coinciden con la referencia.\n";
+    } else {
+        cout << "\nError: " << total << " discrepancias. Primeras:\n";
+        for (const auto& d : detalles) cout << d << "\n";
+    }
+    return total == 0;
+}
+
+void benchmarkVersiones(int lado, int segundos, int lectores) {
+    Grafo g;
+    generarRejilla(g, lado, 7);
+    GrafoVersionado gv;
+    gv.reconstruir(g);
+    int n = g.getNumNodos();
+
+    cout << "\n========== BENCHMARK GRAFO VERSIONADO ==========\n";
+    cout << "Red: " << n << " nodos, lectores: " << lectores << ", duracion: " << segundos << " s por corrida\n";
+
+    for (bool conEscritor : {false, true}) {
+        atomic<bool> parar(false);
+        atomic<long> consultas(0);
+        long publicaciones = 0;
+        double latenciaTotal = 0;
+
+        vector<thread> hilos;
+        for (int t = 0; t < lectores; ++t) {
+            hilos.emplace_back([&, t]() {
+                mt19937 rng(100 + t);
+                uniform_int_distribution<int> nodoDist(0, n - 1);
+                long propias = 0;
+                while (!parar.load(memory_order_relaxed)) {
+                    auto version = gv.fijar();
+                    version->dijkstra(nodoDist(rng), nodoDist(rng));
+                    propias++;
+                }
+                consultas += propias;
+            });
+        }
+
+        thread escritor;
+        if (conEscritor) {
+            escritor = thread([&]() {
+                mt19937 rng(99);
+                uniform_int_distribution<int> nodoDist(0, n - 1);
+                vector<pair<int, Arista>> cerradas;
+                while (!parar.load(memory_order_relaxed)) {
+                    auto inicio = chrono::steady_clock::now();
+                    EdicionGrafo ed = gv.editar();
+                    if (cerradas.size() < 50) {
+                        int u = nodoDist(rng);
+                        const auto& adj = ed.version().nodo(u).adj;
+                        if (adj.empty()) continue;
+                        Arista a = adj[rng() % adj.size()];
+                        ed.bajaArista(u, a.to);
+                        cerradas.push_back({u, a});
+                    } else {
+                        for (const auto& c : cerradas) ed.altaArista(c.first, c.second.to, c.second.w);
+                        cerradas.clear();
+                    }
+                    gv.publicar(ed);
+                    latenciaTotal += chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+                    publicaciones++;
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                }
+            });
+        }
+
+        this_thread::sleep_for(chrono::seconds(segundos));
+        parar = true;
+        for (auto& h : hilos) h.join();
+        if (escritor.joinable()) escritor.join();
+
+        cout << (conEscritor ? "Con escritor: " : "Sin escritor: ") << fixed << setprecision(1)
+             << consultas.load() / static_cast<double>(segundos) << " rutas/seg";
+        if (conEscritor) {
+            cout << ", " << publicaciones << " versiones publicadas, latencia media de publicacion "
+                 << (publicaciones ? latenciaTotal / publicaciones : 0) << " us";
+        }
+        cout << endl;
+    }
+}
+
+bool pruebaVersionesFijadas(int ediciones, int lectores) {
+    // Bloque y medio: el ultimo bloque queda incompleto y compartido con las
+    // versiones siguientes hasta que una edicion le agrega nodos
+    const int base = VersionGrafo::TAM_BLOQUE + VersionGrafo::TAM_BLOQUE / 2;
+    const int porEdicion = 5;
+    GrafoVersionado gv;
+    vector<string> nombres;
+    {
+        EdicionGrafo ed = gv.editar();
+        for (int i = 0; i < base; ++i) {
+            nombres.push_back("n" + to_string(i));
+            ed.altaNodo(i, nombres.back());
+        }
+        for (int i = 0; i + 1 < base; ++i) ed.altaArista(i, i + 1, 1);
+        gv.publicar(ed);
+    }
+
+    cout << "\n========== PRUEBA DE VERSIONES FIJADAS ==========\n";
+    cout << "Version fijada: " << base << " nodos, " << lectores << " lectores, " << ediciones
+         << " ediciones de " << porEdicion << " altas\n";
+
+    auto fijada = gv.fijar();
+    atomic<bool> parar(false);
+    atomic<long> errores(0), pasadas(0);
+    vector<thread> hilos;
+    for (int t = 0; t < lectores; ++t) {
+        hilos.emplace_back([&]() {
+            while (!parar.load(memory_order_relaxed)) {
+                long propios = 0;
+                for (int id = 0; id < base; ++id) {
+                    const NodoVersion& n = fijada->nodo(id);
+                    size_t grado = id + 1 < base ? 1 : 0;
+                    if (n.id != id || n.nombre != nombres[id] || n.adj.size() != grado) propios++;
+                }
+                errores += propios;
+                pasadas++;
+            }
+        });
+    }
+
+    int siguiente = base;
+    for (int e = 0; e < ediciones; ++e) {
+        EdicionGrafo ed = gv.editar();
+        for (int k = 0; k < porEdicion; ++k, ++siguiente) {
+            ed.altaNodo(siguiente, "m" + to_string(siguiente));
+            ed.altaArista(siguiente - 1, siguiente, 1);
+        }
+        gv.publicar(ed);
+    }
+    parar = true;
+    for (auto& h : hilos) h.join();
+
+    // La version fijada no ve nada de lo publicado despues
+    if (fijada->getNumNodos() != base || fijada->getIdByName("m" + to_string(base)) != -1) errores++;
+    if (fijada->dijkstra(0, base - 1).distancia != base - 1) errores++;
+    if (fijada->nodo(base - 1).adj.size() != 0) errores++;
+    auto actual = gv.fijar();
+    if (actual->getNumNodos() != siguiente || actual->dijkstra(0, siguiente - 1).distancia != siguiente - 1) errores++;
+
+    cout << "Pasadas de lectura: " << pasadas.load() << ", version final: " << actual->getNumNodos() << " nodos\n";
+    if (errores.load() == 0) {
+        cout << "La version fijada no cambio.\n";
+        return true;
+    }
+    cout << "Error: " << errores.load() << " lecturas inconsistentes en la version fijada.\n";
+    return false;
+}
+
+bool pruebaPerfiles() {
+    const char* rechazados[] = {
+        "", "08:00", "08:00*", "08:00*abc", "08:00*0", "08:00*-1", "08:00*70",
+        "08:00*nan", "08:00*inf", "25:00*1", "08:00*1,08:00*2", "07:00*3,07:01*1",
+    };
+    Grafo g;
+    g.altaNodo(0, "A");
+    g.altaNodo(1, "B");
+    g.altaArista(0, 1, 10);
+
+    cout << "\n========== PRUEBA DE PERFILES ==========\n";
+    int errores = 0;
+    for (const char* texto : rechazados) {
+        if (g.asignarPerfil(0, 1, texto)) {
+            cout << "Error: se acepto el perfil \"" << texto << "\"\n";
+            errores++;
+        }
+    }
+    if (!g.asignarPerfil(0, 1, "07:00*1,08:00*2.5,10:00*1")) {
+        cout << "Error: se rechazo un perfil valido\n";
+        errores++;
+    }
+    if (errores == 0) {
+        cout << "Perfiles invalidos rechazados: " << size(rechazados) << endl;
+        return true;
+    }
+    return false;
+}
+
+void benchmarkHashConcurrente(int numOps, int porcentajeEscrituras) {
+    const int NUM_CLAVES = 100000;
+    vector<string> claves(NUM_CLAVES);
+    for (int i = 0; i < NUM_CLAVES; ++i) claves[i] = "V" + to_string(i);
+
+    int maxHilos = max(static_cast<int>(thread::hardware_concurrency()), 1) * 2;
+    maxHilos = min(maxHilos, 64);
+
+    cout << "\n========== BENCHMARK TABLA HASH CONCURRENTE ==========\n";
+    cout << "Operaciones por corrida: " << numOps << " (" << porcentajeEscrituras 
+         << "% escrituras), nucleos: " << thread::hardware_concurrency() << endl;
+    cout << setw(10) << "Franjas" << setw(8) << "Hilos" << setw(16) << "Ops/seg" 
+         << setw(12) << "Speedup" << endl;
+    cout << string(46, '-') << endl;
+
+    for (int numFranjas : {1, 64}) {
+        double base = 0;
+        for (int hilos = 1; hilos <= maxHilos; hilos *= 2) {
+            HashTableConcurrente ht(numFranjas, 1 << 16);
+            for (int i = 0; i < NUM_CLAVES; i += 2) {
+                Vehiculo v{claves[i], "Particular", "P" + to_string(i), i % 100, (i * 7) % 100, "07:00"};
+                ht.insert(claves[i], v);
+            }
+
+            vector<thread> workers;
+            auto inicio = chrono::steady_clock::now();
+            for (int t = 0; t < hilos; ++t) {
+                workers.emplace_back([&, t]() {
+                    mt19937 rng(12345 + t);
+                    uniform_int_distribution<int> claveDist(0, NUM_CLAVES - 1);
+                    uniform_int_distribution<int> opDist(0, 99);
+                    Vehiculo v{"", "Particular", "BENCH", 1, 2, "08:00"};
+                    Vehiculo leido;
+                    int misOps = numOps / hilos;
+                    for (int i = 0; i < misOps; ++i) {
+                        const string& k = claves[claveDist(rng)];
+                        int op = opDist(rng);
+                        if (op < porcentajeEscrituras / 2) {
+                            v.id = k;
+                            ht.insert(k, v);
+                        } else if (op < porcentajeEscrituras) {
+                            ht.remove(k);
+                        } else {
+                            ht.search(k, leido);
+                        }
+                    }
+                });
+            }
+            for (auto& w : workers) w.join();
+            double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+            double opsSeg = numOps / max(seg, 1e-9);
+            if (hilos == 1) base = opsSeg;
+            cout << setw(10) << numFranjas << setw(8) << hilos << setw(16) << fixed << setprecision(0) 
+                 << opsSeg << setw(11) << setprecision(2) << opsSeg / base << "x" << endl;
+        }
+    }
+}
+
+}  // namespace trafico
@@ -0,0 +1,85 @@
+// Benchmarks de la biblioteca y prueba diferencial de los motores de rutas.
+#ifndef TRAFICO_BENCHMARKS_H
+#define TRAFICO_BENCHMARKS_H
+
+#include "trafico/trafico.h"
+
+namespace trafico {
+
+void mostrarAsignacion(const GrafoCSR& red, const AsignacionEquilibrio& asig, double segundos);
+
+void mostrarSimulacion(const GrafoCSR& red, const ResultadoSimulacion& res);
+
+// Simulacion de un dia con vehiculos sinteticos sobre una rejilla. Los
+// viajes van entre 'zonas' (nodos elegidos al azar), como en una matriz OD.
+void benchmarkSimulacion(int lado, int numVehiculos, int zonas, int hilos);
+
+// Asignacion en equilibrio sobre una rejilla con demanda sintetica, repetida
+// con 1, 2, 4... hilos para medir el escalamiento de las rondas todo-o-nada
+void benchmarkAsignacion(int lado, int numVehiculos, int zonas, int iteraciones);
+
+// Tiempo medio por consulta de rutas alternativas entre pares al azar
+void benchmarkAlternativas(int lado, int consultas, int k);
+
+// Efecto del orden de los nodos sobre la localidad. La rejilla se renumera al
+// azar (como los codigos municipales) y despues se reordena con cada metodo;
+// las consultas usan los mismos nodos de origen en todas las variantes.
+void benchmarkReordenamiento(int lado, int consultas);
+
+// Arboles de Dijkstra sobre una rejilla con nodos concentradores (hubs) de
+// alto grado, con cada variante del nucleo de relajacion. Comprueba que todas
+// dan las mismas distancias que la escalar.
+void benchmarkRelajacion(int lado, int hubs, int gradoHub, int consultas);
+
+// Tamano y velocidad de la adyacencia comprimida frente a la del Grafo y la
+// del CSR, con consultas punto a punto entre los mismos pares
+void benchmarkCompresion(int lado, int consultas);
+
+// Prueba diferencial de los motores de rutas. Genera redes aleatorias y
+// adversas, resuelve las mismas consultas con cada motor y compara contra una
+// referencia independiente: Dijkstra O(n^2) sin cola de prioridad, en doble
+// precision, sobre una copia propia de la lista de aristas. Tambien revisa que
+// cada camino devuelto empiece y termine donde debe, use aristas existentes y
+// sume la distancia reportada.
+struct EscenarioPrueba {
+    std::string nombre;
+    int numNodos = 0;
+    std::vector<bool> existe;
+    std::vector<std::vector<std::pair<int, float>>> ady;  // copia de referencia de las aristas
+};
+
+// Construye el escenario 'tipo' a la vez en el Grafo y en la copia de referencia
+void generarEscenario(int tipo, std::mt19937& rng, Grafo& g, EscenarioPrueba& esc);
+
+// Distancias de referencia desde s y numero de aristas del camino elegido
+void distanciasReferencia(const EscenarioPrueba& esc, int s, std::vector<double>& dist, std::vector<int>& saltos);
+
+struct MotorPrueba {
+    std::string nombre;
+    long consultas = 0;
+    long discrepancias = 0;
+    double segundos = 0;
+};
+
+bool pruebaDiferencial(int rondas, unsigned semilla);
+
+// Lectores enrutando sobre versiones fijadas mientras un escritor cierra y
+// reabre calles, comparado con los mismos lectores sin escritor
+void benchmarkVersiones(int lado, int segundos, int lectores);
+
+// Fija una version con el ultimo bloque incompleto y la lee desde varios
+// hilos mientras otras ediciones agregan nodos; la version fijada no debe
+// cambiar. Conviene correrla tambien con -fsanitize=thread.
+bool pruebaVersionesFijadas(int ediciones, int lectores);
+
+// Perfiles por hora mal formados, fuera de rango, con NaN/inf o con minutos
+// repetidos deben rechazarse; uno valido debe aceptarse
+bool pruebaPerfiles();
+
+// Prueba de estres: varios hilos mezclando altas, bajas y busquedas sobre
+// la tabla concurrente, comparando una sola franja (candado global) con franjas.
+void benchmarkHashConcurrente(int numOps, int porcentajeEscrituras);
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,51 @@
+// Corre los benchmarks sin menu, con tamanos fijos. Sirve tambien como carga
+// de entrenamiento para compilar con PGO (ver CMakeLists.txt).
+//   trafico_bench              todos los benchmarks
+//   trafico_bench <nombre>...  solo los indicados
+// Termina con codigo 1 si alguna prueba (diferencial, fijadas, perfiles) falla.
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmarks.h"
+
+using namespace std;
+using namespace trafico;
+
+// correr devuelve false si una prueba encontro errores
+struct BenchmarkNombrado {
+    const char* nombre;
+    bool (*correr)();
+};
+
+const BenchmarkNombrado BENCHMARKS[] = {
+    {"hash", []() { benchmarkHashConcurrente(400000, 20); return true; }},
+    {"versiones", []() { benchmarkVersiones(100, 1, 2); return true; }},
+    {"simulacion", []() { benchmarkSimulacion(100, 20000, 40, 2); return true; }},
+    {"asignacion", []() { benchmarkAsignacion(60, 5000, 20, 15); return true; }},
+    {"alternativas", []() { benchmarkAlternativas(60, 40, 4); return true; }},
+    {"reordenamiento", []() { benchmarkReordenamiento(150, 100); return true; }},
+    {"relajacion", []() { benchmarkRelajacion(150, 20, 64, 100); return true; }},
+    {"compresion", []() { benchmarkCompresion(150, 100); return true; }},
+    {"diferencial", []() { return pruebaDiferencial(10, 1); }},
+    {"fijadas", []() { return pruebaVersionesFijadas(2000, 2); }},
+    {"perfiles", pruebaPerfiles},
+};
+
+int main(int argc, char** argv) {
+    vector<string> pedidos(argv + 1, argv + argc);
+    int corridos = 0, fallidos = 0;
+    for (const auto& b : BENCHMARKS) {
+        bool pedido = pedidos.empty();
+        for (const auto& p : pedidos) pedido = pedido || p == b.nombre;
+        if (!pedido) continue;
+        if (!b.correr()) fallidos++;
+        corridos++;
+    }
+    if (corridos == 0) {
+        cerr << "Uso: " << argv[0] << " [nombre...]\nBenchmarks:";
+        for (const auto& b : BENCHMARKS) cerr << " " << b.nombre;
+        cerr << endl;
+        return 1;
+    }
+    return fallidos ? 1 : 0;
+}
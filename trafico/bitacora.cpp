@@ -0,0 +1,181 @@
+#include "bitacora.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace trafico {
+
+bool Bitacora::sincronizar(const string& ruta) {
+    int f = ::open(ruta.c_str(), O_RDONLY);
+    if (f < 0) return false;
+    bool ok = ::fsync(f) == 0;
+    ::close(f);
+    return ok;
+}
+
+bool Bitacora::escribirTodo(int f, const string& datos) {
+    size_t escrito = 0;
+    while (escrito < datos.size()) {
+        ssize_t n = ::write(f, datos.data() + escrito, datos.size() - escrito);
+        if (n < 0) return false;
+        escrito += n;
+    }
+    return true;
+}
+
+string Bitacora::directorioDe(const string& ruta) {
+    size_t pos = ruta.find_last_of('/');
+    return pos == string::npos ? "." : (pos == 0 ? "/" : ruta.substr(0, pos));
+}
+
+bool Bitacora::abrirJournal() {
+    fd = ::open(rutaJournal().c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    return fd >= 0;
+}
+
+void Bitacora::aplicarRegistro(const string& line) {
+    vector<string> campos;
+    stringstream ss(line);
+    string token;
+    while (getline(ss, token, ';')) campos.push_back(token);
+    if (campos.empty()) return;
+    const string& type = campos[0];
+
+    try {
+        if (type == "N" && campos.size() >= 3) {
+            // El nombre puede contener espacios: se toma el resto de la linea
+            size_t pos = line.find(';', line.find(';') + 1);
+            g.altaNodo(stoi(campos[1]), line.substr(pos + 1));
+        } else if (type == "BN" && campos.size() >= 2) {
+            g.bajaNodo(stoi(campos[1]));
+        } else if (type == "E" && campos.size() >= 4) {
+            g.altaArista(stoi(campos[1]), stoi(campos[2]), stof(campos[3]));
+        } else if (type == "BE" && campos.size() >= 3) {
+            g.bajaArista(stoi(campos[1]), stoi(campos[2]));
+        } else if (type == "P" && campos.size() >= 4) {
+            g.asignarPerfil(stoi(campos[1]), stoi(campos[2]), campos[3]);
+        } else if (type == "C" && campos.size() >= 4) {
+            g.fijarCoordenadas(stoi(campos[1]), stof(campos[2]), stof(campos[3]));
+        } else {
+            EventoVehiculo ev;
+            if (parseEventoVehiculo(line, ev)) {
+                if (ev.alta) ht.insert(ev.v.id, ev.v);
+                else ht.remove(ev.v.id);
+            }
+        }
+    } catch (const exception&) {
+        // Registro truncado por una caida: se ignora
+    }
+}
+
+Bitacora::~Bitacora() {
+    confirmar();
+    if (fd >= 0) ::close(fd);
+}
+
+int Bitacora::recuperar() {
+    int reproducidos = 0;
+    ifstream file(rutaJournal());
+    if (file.is_open()) {
+        string line;
+        bool primera = true;
+        while (getline(file, line)) {
+            if (primera) {
+                primera = false;
+                if (line.compare(0, 2, "G;") == 0) {
+                    generacion = atoi(line.c_str() + 2);
+                    ifstream red(rutaRed(generacion));
+                    if (red.is_open()) {
+                        red.close();
+                        g.cargar(rutaRed(generacion));
+                        ht.cargar(rutaVeh(generacion));
+                    }
+                    continue;
+                }
+            }
+            if (file.eof()) break;  // ultima linea sin '\n': escritura incompleta
+            if (line.empty() || line[0] == '#') continue;
+            aplicarRegistro(line);
+            reproducidos++;
+        }
+        file.close();
+    }
+    registrosDesdeCompactacion = reproducidos;
+    if (!abrirJournal()) {
+        error = "No se pudo abrir la bitacora " + rutaJournal();
+    } else if (lseek(fd, 0, SEEK_END) == 0) {
+        escribirTodo(fd, "G;" + to_string(generacion) + "\n");
+        ::fsync(fd);
+    }
+    return reproducidos;
+}
+
+void Bitacora::registrar(const string& registro) {
+    if (fd < 0) return;
+    if (registrosPendientes == 0) primerPendiente = chrono::steady_clock::now();
+    pendiente += registro;
+    pendiente += '\n';
+    registrosPendientes++;
+    registrosDesdeCompactacion++;
+
+    if (registrosPendientes >= tamGrupo || chrono::steady_clock::now() - primerPendiente >= intervaloGrupo) {
+        confirmar();
+    }
+    if (registrosDesdeCompactacion >= umbralCompactacion) {
+        compactar();
+    }
+}
+
+bool Bitacora::confirmar() {
+    if (fd < 0 || pendiente.empty()) return true;
+    TramoTraza tramo("bitacora.confirmar");
+    bool ok = escribirTodo(fd, pendiente) && ::fsync(fd) == 0;
+    if (!ok) error = "Error al escribir la bitacora " + rutaJournal();
+    pendiente.clear();
+    registrosPendientes = 0;
+    return ok;
+}
+
+bool Bitacora::compactar() {
+    TramoTraza tramo("bitacora.compactar");
+    confirmar();
+    int nueva = generacion + 1;
+    string redTmp = rutaRed(nueva) + ".tmp";
+    string vehTmp = rutaVeh(nueva) + ".tmp";
+    // Una instantanea incompleta no debe reemplazar a la anterior ni vaciar el journal
+    if (!g.guardar(redTmp) || !ht.guardar(vehTmp) || !sincronizar(redTmp) || !sincronizar(vehTmp) ||
+        ::rename(redTmp.c_str(), rutaRed(nueva).c_str()) != 0 ||
+        ::rename(vehTmp.c_str(), rutaVeh(nueva).c_str()) != 0) {
+        ::remove(redTmp.c_str());
+        ::remove(vehTmp.c_str());
+        ::remove(rutaRed(nueva).c_str());
+        error = "No se pudo escribir la instantanea; se conserva la bitacora.";
+        return false;
+    }
+
+    string tmp = rutaJournal() + ".tmp";
+    int nuevoFd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (nuevoFd < 0 || !escribirTodo(nuevoFd, "G;" + to_string(nueva) + "\n") || ::fsync(nuevoFd) != 0) {
+        if (nuevoFd >= 0) ::close(nuevoFd);
+        error = "No se pudo reiniciar la bitacora.";
+        return false;
+    }
+    ::close(nuevoFd);
+    if (::rename(tmp.c_str(), rutaJournal().c_str()) != 0) {
+        error = "No se pudo reiniciar la bitacora.";
+        return false;
+    }
+    sincronizar(directorioDe(rutaJournal()));
+
+    if (fd >= 0) ::close(fd);
+    abrirJournal();
+    ::remove(rutaRed(generacion).c_str());
+    ::remove(rutaVeh(generacion).c_str());
+    generacion = nueva;
+    registrosDesdeCompactacion = 0;
+    return true;
+}
+
+}  // namespace trafico
@@ -0,0 +1,110 @@
+// Bitacora de escritura anticipada para la red y los vehiculos.
+#ifndef TRAFICO_BITACORA_H
+#define TRAFICO_BITACORA_H
+
+#include "vehiculos.h"
+
+namespace trafico {
+
+// Bitacora de escritura anticipada (write-ahead) para la red y los vehiculos.
+// Cada alta/baja se agrega al final de <base>.journal y se confirma antes de
+// aplicarla; las escrituras de un lote se agrupan en un solo fsync. La primera linea del
+// journal ("G;n") indica la generacion de la instantanea (<base>.n.red y
+// <base>.n.veh) sobre la que se reproducen los registros. Al compactar se
+// escribe la generacion n+1 y se reemplaza el journal con un rename atomico,
+// de modo que una caida en cualquier punto deja un estado consistente.
+// Los perfiles por hora ("P") y las coordenadas ("C") tienen registro propio:
+// quien los cambie fuera de una carga debe registrarlos como las altas.
+// No escribe en consola: el ultimo fallo queda en tomarError().
+class Bitacora {
+private:
+    Grafo& g;
+    HashTable& ht;
+    std::string base;
+    int fd;
+    int generacion;
+    std::string error;
+    std::string pendiente;
+    int registrosPendientes;
+    int registrosDesdeCompactacion;
+    std::chrono::steady_clock::time_point primerPendiente;
+
+    int tamGrupo;
+    std::chrono::milliseconds intervaloGrupo;
+    int umbralCompactacion;
+
+    std::string rutaJournal() const { return base + ".journal"; }
+    std::string rutaRed(int gen) const { return base + "." + std::to_string(gen) + ".red"; }
+    std::string rutaVeh(int gen) const { return base + "." + std::to_string(gen) + ".veh"; }
+
+    static bool sincronizar(const std::string& ruta);
+
+    static bool escribirTodo(int f, const std::string& datos);
+
+    static std::string directorioDe(const std::string& ruta);
+
+    bool abrirJournal();
+
+    void aplicarRegistro(const std::string& line);
+
+public:
+    Bitacora(Grafo& grafo, HashTable& tabla, const std::string& rutaBase = "trafico",
+             int grupo = 64, int intervaloMs = 200, int compactarCada = 50000)
+        : g(grafo), ht(tabla), base(rutaBase), fd(-1), generacion(0),
+          registrosPendientes(0), registrosDesdeCompactacion(0),
+          tamGrupo(grupo), intervaloGrupo(intervaloMs), umbralCompactacion(compactarCada) {}
+
+    ~Bitacora();
+
+    Bitacora(const Bitacora&) = delete;
+    Bitacora& operator=(const Bitacora&) = delete;
+
+    // Carga la ultima instantanea y reproduce el journal. Devuelve el numero
+    // de registros reproducidos (0 si no habia bitacora previa).
+    int recuperar();
+
+    // Agrega el registro al grupo pendiente, sin hacerlo durable: quien vaya a
+    // aplicar y dar por hecho el cambio debe llamar antes a confirmar(). El
+    // tamano y el intervalo del grupo solo acotan lo que se acumula entre
+    // registros seguidos; un registro aislado espera a confirmar().
+    void registrar(const std::string& registro);
+
+    void altaNodo(int id, const std::string& nombre) { registrar("N;" + std::to_string(id) + ";" + nombre); }
+    void bajaNodo(int id) { registrar("BN;" + std::to_string(id)); }
+    void altaArista(int from, int to, float w) {
+        std::ostringstream os;
+        os << "E;" << from << ";" << to << ";" << std::setprecision(9) << w;
+        registrar(os.str());
+    }
+    void asignarPerfil(int from, int to, const std::string& texto) {
+        registrar("P;" + std::to_string(from) + ";" + std::to_string(to) + ";" + texto);
+    }
+    void fijarCoordenadas(int id, float x, float y) {
+        std::ostringstream os;
+        os << "C;" << id << ";" << std::setprecision(9) << x << ";" << y;
+        registrar(os.str());
+    }
+    void bajaArista(int from, int to) { registrar("BE;" + std::to_string(from) + ";" + std::to_string(to)); }
+    void altaVehiculo(const Vehiculo& v) { registrar(registroVehiculo(v)); }
+    void bajaVehiculo(const std::string& id) { registrar("B;" + id); }
+
+    // Escribe el grupo pendiente y lo hace durable con un solo fsync
+    bool confirmar();
+
+    // Escribe una instantanea nueva y deja el journal vacio apuntando a ella
+    bool compactar();
+
+    // Devuelve y olvida el ultimo error (vacio si no hubo)
+    std::string tomarError() {
+        std::string e;
+        e.swap(error);
+        return e;
+    }
+
+    int getGeneracion() const { return generacion; }
+    int getRegistrosDesdeCompactacion() const { return registrosDesdeCompactacion; }
+};
+
+}  // namespace trafico
+
+#endif
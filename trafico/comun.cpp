@@ -0,0 +1,29 @@
+#include "comun.h"
+
+using namespace std;
+
+namespace trafico {
+
+int horaAMinutos(const string& hhmm) {
+    size_t sep = hhmm.find(':');
+    if (sep == string::npos || sep == 0 || sep + 1 >= hhmm.size()) return -1;
+    int h = 0, m = 0;
+    for (size_t i = 0; i < hhmm.size(); ++i) {
+        if (i == sep) continue;
+        if (!isdigit(static_cast<unsigned char>(hhmm[i]))) return -1;
+        int& campo = i < sep ? h : m;
+        campo = campo * 10 + (hhmm[i] - '0');
+        if (campo > 99) return -1;
+    }
+    if (h > 23 || m > 59) return -1;
+    return h * 60 + m;
+}
+
+string minutosAHora(int minutos) {
+    minutos = ((minutos % MINUTOS_DIA) + MINUTOS_DIA) % MINUTOS_DIA;
+    char buf[6];
+    snprintf(buf, sizeof(buf), "%02d:%02d", minutos / 60, minutos % 60);
+    return buf;
+}
+
+}  // namespace trafico
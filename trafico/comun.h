@@ -0,0 +1,44 @@
+// Tipos y utilidades comunes de la biblioteca de trafico.
+#ifndef TRAFICO_COMUN_H
+#define TRAFICO_COMUN_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace trafico {
+
+// Utilidades de tiempo: las horas "HH:MM" se manejan como minutos del dia
+const int MINUTOS_DIA = 24 * 60;
+
+int horaAMinutos(const std::string& hhmm);
+
+std::string minutosAHora(int minutos);
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,445 @@
+#include "csr.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TRAFICO_X86 1
+#endif
+
+using namespace std;
+
+namespace trafico {
+
+int relajarEscalar(float du, const int* destino, const float* costo, int n, const float* dist, int* candidatos) {
+    int m = 0;
+    for (int k = 0; k < n; ++k) {
+        if (du + costo[k] < dist[destino[k]]) candidatos[m++] = k;
+    }
+    return m;
+}
+
+#ifdef TRAFICO_X86
+// SSE2 (siempre disponible en x86-64): suma y compara de 4 en 4; sin gather,
+// las distancias se cargan una a una
+int relajarSSE(float du, const int* destino, const float* costo, int n, const float* dist, int* candidatos) {
+    int m = 0, k = 0;
+    __m128 vdu = _mm_set1_ps(du);
+    for (; k + 4 <= n; k += 4) {
+        __m128 nd = _mm_add_ps(vdu, _mm_loadu_ps(costo + k));
+        __m128 actual = _mm_set_ps(dist[destino[k + 3]], dist[destino[k + 2]], dist[destino[k + 1]], dist[destino[k]]);
+        int mascara = _mm_movemask_ps(_mm_cmplt_ps(nd, actual));
+        while (mascara) {
+            candidatos[m++] = k + __builtin_ctz(mascara);
+            mascara &= mascara - 1;
+        }
+    }
+    for (; k < n; ++k) {
+        if (du + costo[k] < dist[destino[k]]) candidatos[m++] = k;
+    }
+    return m;
+}
+
+// AVX2: 8 aristas por iteracion, con gather de las distancias de destino
+__attribute__((target("avx2")))
+int relajarAVX2(float du, const int* destino, const float* costo, int n, const float* dist, int* candidatos) {
+    int m = 0, k = 0;
+    __m256 vdu = _mm256_set1_ps(du);
+    for (; k + 8 <= n; k += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destino + k));
+        __m256 nd = _mm256_add_ps(vdu, _mm256_loadu_ps(costo + k));
+        __m256 actual = _mm256_i32gather_ps(dist, idx, 4);
+        int mascara = _mm256_movemask_ps(_mm256_cmp_ps(nd, actual, _CMP_LT_OQ));
+        while (mascara) {
+            candidatos[m++] = k + __builtin_ctz(mascara);
+            mascara &= mascara - 1;
+        }
+    }
+    for (; k < n; ++k) {
+        if (du + costo[k] < dist[destino[k]]) candidatos[m++] = k;
+    }
+    return m;
+}
+#endif
+
+vector<VarianteRelajacion> variantesRelajacion() {
+    vector<VarianteRelajacion> v{{"escalar", relajarEscalar, true}};
+#ifdef TRAFICO_X86
+    v.push_back({"SSE2", relajarSSE, true});
+    v.push_back({"AVX2", relajarAVX2, __builtin_cpu_supports("avx2") != 0});
+#endif
+    return v;
+}
+
+atomic<KernelRelajacion>& kernelRelajacion() {
+    static atomic<KernelRelajacion> actual([]() {
+        KernelRelajacion mejor = relajarEscalar;
+        for (const auto& v : variantesRelajacion()) {
+            if (v.disponible) mejor = v.kernel;
+        }
+        return mejor;
+    }());
+    return actual;
+}
+
+GrafoCSR GrafoCSR::desde(const Grafo& g) {
+    GrafoCSR csr;
+    const auto& nodos = g.getNodos();
+    csr.numNodos = static_cast<int>(nodos.size());
+    csr.inicio.assign(csr.numNodos + 1, 0);
+    csr.nombres.resize(csr.numNodos);
+    for (int u = 0; u < csr.numNodos; ++u) {
+        csr.inicio[u + 1] = csr.inicio[u] + static_cast<int>(nodos[u].adj.size());
+        csr.nombres[u] = nodos[u].nombre;
+    }
+    if (g.tieneCoordenadas()) {
+        csr.x.assign(csr.numNodos, numeric_limits<float>::quiet_NaN());
+        csr.y.assign(csr.numNodos, numeric_limits<float>::quiet_NaN());
+        for (int u = 0; u < csr.numNodos; ++u) g.getCoordenadas(u, csr.x[u], csr.y[u]);
+    }
+    csr.destino.reserve(csr.inicio.back());
+    csr.peso.reserve(csr.inicio.back());
+    for (const auto& n : nodos) {
+        for (const auto& a : n.adj) {
+            csr.destino.push_back(a.to);
+            csr.peso.push_back(a.w);
+        }
+    }
+    return csr;
+}
+
+GrafoCSR GrafoCSR::permutado(const vector<int>& orden) const {
+    GrafoCSR r;
+    r.numNodos = numNodos;
+    vector<int> nuevoDe(numNodos);
+    for (int i = 0; i < numNodos; ++i) nuevoDe[orden[i]] = i;
+
+    r.inicio.assign(numNodos + 1, 0);
+    r.nombres.resize(numNodos);
+    r.idExterno.resize(numNodos);
+    r.idInterno.resize(numNodos);
+    if (tieneCoordenadas()) {
+        r.x.resize(numNodos);
+        r.y.resize(numNodos);
+    }
+    r.destino.reserve(destino.size());
+    r.peso.reserve(peso.size());
+    vector<pair<int, float>> aristas;
+    for (int i = 0; i < numNodos; ++i) {
+        int u = orden[i];
+        r.nombres[i] = nombres[u];
+        r.idExterno[i] = externo(u);
+        r.idInterno[externo(u)] = i;
+        if (tieneCoordenadas()) {
+            r.x[i] = x[u];
+            r.y[i] = y[u];
+        }
+        aristas.clear();
+        for (int k = inicio[u]; k < inicio[u + 1]; ++k) aristas.push_back({nuevoDe[destino[k]], peso[k]});
+        sort(aristas.begin(), aristas.end());
+        for (const auto& [v, w] : aristas) {
+            r.destino.push_back(v);
+            r.peso.push_back(w);
+        }
+        r.inicio[i + 1] = static_cast<int>(r.destino.size());
+    }
+    return r;
+}
+
+void GrafoCSR::arbolDesde(int s, const float* costo, vector<float>& dist, vector<int>& predArista, int objetivo) const {
+    const float INF = numeric_limits<float>::infinity();
+    if (!costo) costo = peso.data();
+    dist.assign(numNodos, INF);
+    predArista.assign(numNodos, -1);
+    MedicionOperacion med(Operacion::ArbolCSR);
+    KernelRelajacion relajar = kernelRelajacion().load(memory_order_relaxed);
+    vector<int> candidatos;
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    dist[s] = 0;
+    pq.push({0, s});
+    med.conteo.pushes++;
+    while (!pq.empty()) {
+        float du = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (du > dist[u]) continue;
+        med.conteo.asentados++;
+        if (u == objetivo) break;
+
+        auto aplicar = [&](int k) {
+            float nd = du + costo[k];
+            int v = destino[k];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                predArista[v] = k;
+                pq.push({nd, v});
+                med.conteo.pushes++;
+            }
+        };
+        int grado = inicio[u + 1] - inicio[u];
+        med.conteo.relajadas += grado;
+        if (grado >= GRADO_MINIMO_SIMD) {
+            if (static_cast<int>(candidatos.size()) < grado) candidatos.resize(grado);
+            int m = relajar(du, &destino[inicio[u]], &costo[inicio[u]], grado, dist.data(), candidatos.data());
+            for (int c = 0; c < m; ++c) aplicar(inicio[u] + candidatos[c]);
+        } else {
+            for (int k = inicio[u]; k < inicio[u + 1]; ++k) aplicar(k);
+        }
+    }
+}
+
+GrafoCSR GrafoCSR::transpuesto() const {
+    GrafoCSR t;
+    t.numNodos = numNodos;
+    t.nombres = nombres;
+    t.x = x;
+    t.y = y;
+    t.idExterno = idExterno;
+    t.idInterno = idInterno;
+    t.inicio.assign(numNodos + 1, 0);
+    for (int v : destino) t.inicio[v + 1]++;
+    for (int u = 0; u < numNodos; ++u) t.inicio[u + 1] += t.inicio[u];
+    t.destino.resize(destino.size());
+    t.peso.resize(peso.size());
+    t.aristaOriginal.resize(destino.size());
+    vector<int> pos(t.inicio.begin(), t.inicio.end() - 1);
+    for (int u = 0; u < numNodos; ++u) {
+        for (int k = inicio[u]; k < inicio[u + 1]; ++k) {
+            int p = pos[destino[k]]++;
+            t.destino[p] = u;
+            t.peso[p] = peso[k];
+            t.aristaOriginal[p] = k;
+        }
+    }
+    return t;
+}
+
+const char* nombreOrden(OrdenNodos o) {
+    switch (o) {
+        case OrdenNodos::BFS: return "BFS";
+        case OrdenNodos::RCM: return "RCM";
+        case OrdenNodos::Hilbert: return "Hilbert";
+        default: return "Original";
+    }
+}
+
+void vecinosNoDirigidos(const GrafoCSR& red, vector<int>& inicio, vector<int>& vecinos) {
+    int n = red.numNodos;
+    inicio.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+            inicio[u + 1]++;
+            inicio[red.destino[k] + 1]++;
+        }
+    }
+    for (int u = 0; u < n; ++u) inicio[u + 1] += inicio[u];
+    vecinos.resize(inicio[n]);
+    vector<int> pos(inicio.begin(), inicio.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+            vecinos[pos[u]++] = red.destino[k];
+            vecinos[pos[red.destino[k]]++] = u;
+        }
+    }
+}
+
+vector<int> ordenAnchura(const GrafoCSR& red, bool porGrado) {
+    int n = red.numNodos;
+    vector<int> inicio, vecinos;
+    vecinosNoDirigidos(red, inicio, vecinos);
+    auto grado = [&](int u) { return inicio[u + 1] - inicio[u]; };
+
+    vector<int> candidatos;
+    for (int u = 0; u < n; ++u) {
+        if (red.existe(u)) candidatos.push_back(u);
+    }
+    stable_sort(candidatos.begin(), candidatos.end(), [&](int a, int b) { return grado(a) < grado(b); });
+
+    vector<int> orden;
+    orden.reserve(n);
+    vector<char> visto(n, 0);
+    vector<int> nuevos;
+    for (int s : candidatos) {
+        if (visto[s]) continue;
+        visto[s] = 1;
+        size_t cabeza = orden.size();
+        orden.push_back(s);
+        while (cabeza < orden.size()) {
+            int u = orden[cabeza++];
+            nuevos.clear();
+            for (int k = inicio[u]; k < inicio[u + 1]; ++k) {
+                int v = vecinos[k];
+                if (!visto[v] && red.existe(v)) {
+                    visto[v] = 1;
+                    nuevos.push_back(v);
+                }
+            }
+            if (porGrado) {
+                stable_sort(nuevos.begin(), nuevos.end(), [&](int a, int b) { return grado(a) < grado(b); });
+            }
+            orden.insert(orden.end(), nuevos.begin(), nuevos.end());
+        }
+    }
+    if (porGrado) reverse(orden.begin(), orden.end());
+    for (int u = 0; u < n; ++u) {
+        if (!red.existe(u)) orden.push_back(u);
+    }
+    return orden;
+}
+
+uint64_t indiceHilbert(uint32_t x, uint32_t y, int bits) {
+    uint32_t lado = 1u << bits;
+    uint64_t d = 0;
+    for (uint32_t s = lado / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = lado - 1 - x;
+                y = lado - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+vector<int> ordenHilbert(const GrafoCSR& red) {
+    const int BITS = 16;
+    int n = red.numNodos;
+    float minX = numeric_limits<float>::max(), minY = minX;
+    float maxX = numeric_limits<float>::lowest(), maxY = maxX;
+    // Sin coordenadas finitas el nodo va al final: escalarlo seria UB
+    auto ubicado = [&red](int u) { return red.existe(u) && isfinite(red.x[u]) && isfinite(red.y[u]); };
+    for (int u = 0; u < n; ++u) {
+        if (!ubicado(u)) continue;
+        minX = min(minX, red.x[u]);
+        maxX = max(maxX, red.x[u]);
+        minY = min(minY, red.y[u]);
+        maxY = max(maxY, red.y[u]);
+    }
+    float escala = static_cast<float>((1u << BITS) - 1) / max({maxX - minX, maxY - minY, 1e-9f});
+
+    vector<pair<uint64_t, int>> claves;
+    vector<int> resto;
+    for (int u = 0; u < n; ++u) {
+        if (!ubicado(u)) {
+            resto.push_back(u);
+            continue;
+        }
+        auto cx = static_cast<uint32_t>((red.x[u] - minX) * escala);
+        auto cy = static_cast<uint32_t>((red.y[u] - minY) * escala);
+        claves.push_back({indiceHilbert(cx, cy, BITS), u});
+    }
+    sort(claves.begin(), claves.end());
+    vector<int> orden;
+    orden.reserve(n);
+    for (const auto& c : claves) orden.push_back(c.second);
+    // Primero los nodos existentes sin coordenadas, despues los huecos
+    stable_partition(resto.begin(), resto.end(), [&](int u) { return red.existe(u); });
+    orden.insert(orden.end(), resto.begin(), resto.end());
+    return orden;
+}
+
+vector<int> calcularOrden(const GrafoCSR& red, OrdenNodos modo) {
+    switch (modo) {
+        case OrdenNodos::BFS: return ordenAnchura(red, false);
+        case OrdenNodos::RCM: return ordenAnchura(red, true);
+        case OrdenNodos::Hilbert:
+            // Sin coordenadas se recurre al orden BFS
+            if (red.tieneCoordenadas()) return ordenHilbert(red);
+            return ordenAnchura(red, false);
+        default: {
+            vector<int> orden(red.numNodos);
+            for (int u = 0; u < red.numNodos; ++u) orden[u] = u;
+            return orden;
+        }
+    }
+}
+
+LocalidadCSR medirLocalidad(const GrafoCSR& red) {
+    LocalidadCSR loc;
+    double suma = 0;
+    for (int u = 0; u < red.numNodos; ++u) {
+        for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+            int d = abs(red.destino[k] - u);
+            suma += d;
+            loc.anchoBanda = max(loc.anchoBanda, d);
+        }
+    }
+    if (red.numAristas() > 0) loc.distanciaMedia = suma / red.numAristas();
+    return loc;
+}
+
+GrafoCSR redParaConsultas(const Grafo& g, OrdenNodos modo) {
+    GrafoCSR red = GrafoCSR::desde(g);
+    if (modo == OrdenNodos::Original) return red;
+    return red.permutado(calcularOrden(red, modo));
+}
+
+uint32_t GrafoComprimido::leerVarint(const uint8_t*& p) {
+    uint32_t v = *p++;
+    if (v < 0x80) return v;
+    v &= 0x7f;
+    for (int corrimiento = 7; ; corrimiento += 7) {
+        uint32_t b = *p++;
+        v |= (b & 0x7f) << corrimiento;
+        if (b < 0x80) return v;
+    }
+}
+
+GrafoComprimido GrafoComprimido::desde(const GrafoCSR& red, bool cuantizar) {
+    GrafoComprimido c;
+    c.numNodos = red.numNodos;
+    c.numAristas = red.numAristas();
+    c.cuantizado = cuantizar;
+    if (cuantizar) {
+        float maximo = 0;
+        for (float w : red.peso) maximo = max(maximo, w);
+        c.escala = maximo > 0 ? maximo / numeric_limits<uint16_t>::max() : 1.0f;
+    }
+    c.existentes.resize(red.numNodos);
+    c.desplazamiento.resize(red.numNodos + 1);
+    c.datos.reserve(red.numNodos + red.numAristas() * (cuantizar ? 3 : 5));
+    vector<pair<int, float>> aristas;
+    for (int u = 0; u < red.numNodos; ++u) {
+        c.existentes[u] = red.existe(u);
+        c.desplazamiento[u] = static_cast<uint32_t>(c.datos.size());
+        aristas.clear();
+        for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) aristas.push_back({red.destino[k], red.peso[k]});
+        sort(aristas.begin(), aristas.end());
+        escribirVarint(c.datos, static_cast<uint32_t>(aristas.size()));
+        int anterior = u;
+        for (size_t i = 0; i < aristas.size(); ++i) {
+            int v = aristas[i].first;
+            escribirVarint(c.datos, i == 0 ? zigzag(v - u) : static_cast<uint32_t>(v - anterior));
+            anterior = v;
+            if (cuantizar) {
+                long q = min<long>(lround(aristas[i].second / c.escala), numeric_limits<uint16_t>::max());
+                auto q16 = static_cast<uint16_t>(q);
+                const auto* b = reinterpret_cast<const uint8_t*>(&q16);
+                c.datos.insert(c.datos.end(), b, b + sizeof(q16));
+            } else {
+                const auto* b = reinterpret_cast<const uint8_t*>(&aristas[i].second);
+                c.datos.insert(c.datos.end(), b, b + sizeof(float));
+            }
+        }
+    }
+    c.desplazamiento[red.numNodos] = static_cast<uint32_t>(c.datos.size());
+    c.datos.shrink_to_fit();
+    return c;
+}
+
+Ruta GrafoComprimido::ruta(int s, int t) const {
+    Ruta r{numeric_limits<float>::infinity(), {}};
+    if (!existe(s) || !existe(t)) return r;
+    vector<float> dist;
+    vector<int> previo;
+    arbolDesde(s, dist, previo, t);
+    if (dist[t] == numeric_limits<float>::infinity()) return r;
+    r.distancia = dist[t];
+    for (int at = t; at != -1; at = previo[at]) r.camino.push_back(at);
+    reverse(r.camino.begin(), r.camino.end());
+    return r;
+}
+
+}  // namespace trafico
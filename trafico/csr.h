@@ -0,0 +1,238 @@
+// Representaciones compactas de la red para consultas (CSR y comprimida).
+#ifndef TRAFICO_CSR_H
+#define TRAFICO_CSR_H
+
+#include "grafo.h"
+
+namespace trafico {
+
+// Nucleo de relajacion de aristas sobre la disposicion SoA del CSR: para las
+// n aristas de un nodo calcula du + costo[k] en bloque, lo compara con
+// dist[destino[k]] y deja en 'candidatos' los indices k que mejoran. El
+// llamador vuelve a comparar al aplicar cada uno (aristas paralelas hacia el
+// mismo destino). La variante se elige una vez segun la CPU.
+using KernelRelajacion = int (*)(float du, const int* destino, const float* costo, int n,
+                                 const float* dist, int* candidatos);
+
+struct VarianteRelajacion {
+    const char* nombre;
+    KernelRelajacion kernel;
+    bool disponible;
+};
+
+// Variantes compiladas, de la mas simple a la mas ancha
+std::vector<VarianteRelajacion> variantesRelajacion();
+
+// Variante en uso: la mas ancha que soporte la CPU (los benchmarks pueden
+// fijar otra para comparar)
+std::atomic<KernelRelajacion>& kernelRelajacion();
+
+// Por debajo de este grado el bucle escalar en linea es mas barato que el salto
+const int GRADO_MINIMO_SIMD = 8;
+
+// Copia compacta de solo lectura de la red en formato CSR: las aristas del
+// nodo u ocupan [inicio[u], inicio[u+1]) en 'destino' y 'peso', y el indice
+// de cada arista sirve como su identificador.
+// Los nodos pueden renumerarse para mejorar la localidad (ver permutado());
+// en ese caso idExterno/idInterno traducen entre el indice interno y el id
+// del Grafo, que es el que ven el usuario, los vehiculos y los archivos.
+struct GrafoCSR {
+    int numNodos = 0;
+    std::vector<int> inicio;
+    std::vector<int> destino;
+    std::vector<float> peso;
+    std::vector<int> aristaOriginal;  // solo en el transpuesto: id de la arista directa
+    std::vector<std::string> nombres;
+    std::vector<float> x, y;          // coordenadas (NaN si el nodo no tiene); vacias si la red no las trae
+    std::vector<int> idExterno;       // vacios mientras la numeracion sea la del Grafo
+    std::vector<int> idInterno;
+
+    static GrafoCSR desde(const Grafo& g);
+
+    int numAristas() const { return static_cast<int>(destino.size()); }
+    bool existe(int u) const { return u >= 0 && u < numNodos && !nombres[u].empty(); }
+    bool tieneCoordenadas() const { return !x.empty(); }
+
+    // Bytes de la estructura de adyacencia (sin nombres ni coordenadas)
+    size_t bytesAdyacencia() const {
+        return inicio.size() * sizeof(int) + destino.size() * sizeof(int) + peso.size() * sizeof(float);
+    }
+
+    // Traduccion entre ids del Grafo e indices internos (-1 si no existe)
+    int interno(int ext) const {
+        if (idInterno.empty()) return ext;
+        return ext >= 0 && ext < numNodos ? idInterno[ext] : -1;
+    }
+    int externo(int u) const { return idExterno.empty() ? u : idExterno[u]; }
+
+    // Copia renumerada: el nodo interno i pasa a ser el antiguo orden[i].
+    // Las aristas de cada nodo quedan ordenadas por destino.
+    GrafoCSR permutado(const std::vector<int>& orden) const;
+
+    // Origen de la arista k (busqueda binaria sobre 'inicio')
+    int origenDe(int k) const {
+        return static_cast<int>(std::upper_bound(inicio.begin(), inicio.end(), k) - inicio.begin()) - 1;
+    }
+
+    // Dijkstra desde s con un costo por arista (indexado como 'destino'; si es
+    // nullptr se usa 'peso'). predArista[v] es la arista por la que se llego a v.
+    // Si se indica 'objetivo' la busqueda termina al fijar ese nodo.
+    void arbolDesde(int s, const float* costo, std::vector<float>& dist, std::vector<int>& predArista, int objetivo = -1) const;
+
+    // Red con las aristas invertidas, recordando la arista directa de cada una
+    GrafoCSR transpuesto() const;
+};
+
+// Reordenamiento de nodos para localidad de cache. Los codigos de nodo de los
+// archivos son arbitrarios y dejan lejos en memoria a nodos vecinos en la red;
+// cada orden devuelve una permutacion (orden[nuevo] = viejo) para
+// GrafoCSR::permutado. Los indices sin nodo (huecos en los codigos) van al
+// final en todos los casos.
+enum class OrdenNodos { Original, BFS, RCM, Hilbert };
+
+const char* nombreOrden(OrdenNodos o);
+
+// Vecinos sin direccion (salientes y entrantes) en formato CSR
+void vecinosNoDirigidos(const GrafoCSR& red, std::vector<int>& inicio, std::vector<int>& vecinos);
+
+// Recorrido en anchura por componentes. Cada componente empieza en su nodo de
+// menor grado; con 'porGrado' los vecinos se visitan de menor a mayor grado y
+// el orden final se invierte (Cuthill-McKee inverso), lo que reduce el ancho
+// de banda de la matriz de adyacencia.
+std::vector<int> ordenAnchura(const GrafoCSR& red, bool porGrado);
+
+// Posicion de (x, y) en la curva de Hilbert de lado 2^bits
+uint64_t indiceHilbert(uint32_t x, uint32_t y, int bits);
+
+// Orden por curva de Hilbert sobre las coordenadas, normalizadas a una
+// rejilla de 2^16 x 2^16; los nodos sin coordenadas van detras
+std::vector<int> ordenHilbert(const GrafoCSR& red);
+
+std::vector<int> calcularOrden(const GrafoCSR& red, OrdenNodos modo);
+
+// Distancia media y maxima (ancho de banda) entre los indices de los extremos
+// de cada arista: cuanto menores, mas cerca en memoria quedan los vecinos
+struct LocalidadCSR {
+    double distanciaMedia = 0;
+    int anchoBanda = 0;
+};
+
+LocalidadCSR medirLocalidad(const GrafoCSR& red);
+
+// CSR para los motores de consulta con el orden de nodos elegido
+GrafoCSR redParaConsultas(const Grafo& g, OrdenNodos modo);
+
+// Adyacencia comprimida de solo lectura. Por nodo se guarda el grado y sus
+// aristas ordenadas por destino: el primer destino como diferencia (zigzag)
+// con el propio nodo y los demas como diferencia con el anterior, todo en
+// varint, de modo que con un buen orden de nodos (ver OrdenNodos) casi todas
+// ocupan un byte. Los pesos van como float o, cuantizados, como enteros de
+// 16 bits por una escala comun (error maximo de escala / 2 por arista).
+// Usa la misma numeracion que el GrafoCSR del que se construye.
+class GrafoComprimido {
+private:
+    int numNodos = 0;
+    int numAristas = 0;
+    bool cuantizado = false;
+    float escala = 1.0f;
+    std::vector<uint32_t> desplazamiento;  // inicio de cada nodo en 'datos'
+    std::vector<uint8_t> datos;
+    std::vector<bool> existentes;
+
+    static void escribirVarint(std::vector<uint8_t>& out, uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static uint32_t leerVarint(const uint8_t*& p);
+
+    static uint32_t zigzag(int v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+    static int desZigzag(uint32_t v) { return static_cast<int>(v >> 1) ^ -static_cast<int>(v & 1); }
+
+    // Lee un peso (float o cuantizado) y avanza p
+    template <bool Cuantizado>
+    float leerPeso(const uint8_t*& p) const {
+        if (Cuantizado) {
+            uint16_t q;
+            memcpy(&q, p, sizeof(q));
+            p += sizeof(q);
+            return q * escala;
+        }
+        float w;
+        memcpy(&w, p, sizeof(w));
+        p += sizeof(w);
+        return w;
+    }
+
+    // Recorre las aristas de u llamando a f(destino, peso)
+    template <bool Cuantizado, typename F>
+    void recorrer(int u, F&& f) const {
+        const uint8_t* p = datos.data() + desplazamiento[u];
+        uint32_t grado = leerVarint(p);
+        if (grado == 0) return;
+        int v = u + desZigzag(leerVarint(p));
+        f(v, leerPeso<Cuantizado>(p));
+        for (uint32_t i = 1; i < grado; ++i) {
+            v += static_cast<int>(leerVarint(p));
+            f(v, leerPeso<Cuantizado>(p));
+        }
+    }
+
+    template <bool Cuantizado>
+    void arbol(int s, std::vector<float>& dist, std::vector<int>& previo, int objetivo, ConteoAlgoritmo& conteo) const {
+        std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> pq;
+        dist[s] = 0;
+        pq.push({0, s});
+        conteo.pushes++;
+        while (!pq.empty()) {
+            float du = pq.top().first;
+            int u = pq.top().second;
+            pq.pop();
+            if (du > dist[u]) continue;
+            conteo.asentados++;
+            if (u == objetivo) break;
+            recorrer<Cuantizado>(u, [&](int v, float w) {
+                conteo.relajadas++;
+                float nd = du + w;
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    previo[v] = u;
+                    pq.push({nd, v});
+                    conteo.pushes++;
+                }
+            });
+        }
+    }
+
+public:
+    static GrafoComprimido desde(const GrafoCSR& red, bool cuantizar);
+
+    int getNumNodos() const { return numNodos; }
+    int getNumAristas() const { return numAristas; }
+    bool esCuantizado() const { return cuantizado; }
+    float getEscala() const { return escala; }
+    bool existe(int u) const { return u >= 0 && u < numNodos && existentes[u]; }
+
+    size_t bytes() const {
+        return desplazamiento.size() * sizeof(uint32_t) + datos.size() + (existentes.size() + 7) / 8;
+    }
+
+    // Dijkstra desde s; previo[v] es el nodo anterior en el arbol. Si se
+    // indica 'objetivo' la busqueda termina al fijar ese nodo.
+    void arbolDesde(int s, std::vector<float>& dist, std::vector<int>& previo, int objetivo = -1) const {
+        dist.assign(numNodos, std::numeric_limits<float>::infinity());
+        previo.assign(numNodos, -1);
+        MedicionOperacion med(Operacion::ArbolComprimido);
+        if (cuantizado) arbol<true>(s, dist, previo, objetivo, med.conteo);
+        else arbol<false>(s, dist, previo, objetivo, med.conteo);
+    }
+
+    Ruta ruta(int s, int t) const;
+};
+
+}  // namespace trafico
+
+#endif
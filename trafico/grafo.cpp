@@ -0,0 +1,692 @@
+#include "grafo.h"
+
+using namespace std;
+
+namespace trafico {
+
+string_view ArenaNombres::guardar(string_view s) {
+    if (s.empty()) return string_view();
+    char* destino;
+    if (s.size() > TAM_BLOQUE / 4) {
+        // Nombres muy largos van en un bloque propio
+        bloques.emplace_back(new char[s.size()]);
+        bytesReservados += s.size();
+        destino = bloques.back().get();
+    } else {
+        if (usadoBloque + s.size() > TAM_BLOQUE) {
+            bloques.emplace_back(new char[TAM_BLOQUE]);
+            bloqueActual = bloques.back().get();
+            usadoBloque = 0;
+            bytesReservados += TAM_BLOQUE;
+        }
+        destino = bloqueActual + usadoBloque;
+        usadoBloque += s.size();
+    }
+    memcpy(destino, s.data(), s.size());
+    bytesUsados += s.size();
+    return string_view(destino, s.size());
+}
+
+void EspacioBusqueda::preparar(int n) {
+    if (static_cast<int>(dist.size()) < n) {
+        dist.resize(n);
+        marca.resize(n, 0);
+    }
+    if (++actual == 0) {
+        fill(marca.begin(), marca.end(), 0);
+        actual = 1;
+    }
+    heap.clear();
+}
+
+bool IndiceNombres::menor(string_view a, string_view b) {
+    size_t n = min(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i) {
+        char ca = minuscula(a[i]), cb = minuscula(b[i]);
+        if (ca != cb) return ca < cb;
+    }
+    return a.size() < b.size();
+}
+
+vector<int> IndiceNombres::porPrefijo(string_view prefijo, size_t maxResultados) const {
+    vector<int> res;
+    auto it = lower_bound(entradas.begin(), entradas.end(), prefijo, [](const pair<string_view, int>& e, string_view p) {
+        return menor(e.first, p);
+    });
+    for (; it != entradas.end() && res.size() < maxResultados && empiezaCon(it->first, prefijo); ++it) {
+        res.push_back(it->second);
+    }
+    return res;
+}
+
+vector<pair<int, int>> IndiceNombres::aproximados(string_view consulta, int maxDist, size_t maxResultados) const {
+    vector<pair<int, int>> res;
+    int m = static_cast<int>(consulta.size());
+    // filas[i]: distancias entre el prefijo de largo i del nombre y cada
+    // prefijo de la consulta; mejor[i]: minimo de filas[0..i][m]
+    vector<vector<int>> filas(1, vector<int>(m + 1));
+    vector<int> mejor(1, m);
+    for (int j = 0; j <= m; ++j) filas[0][j] = j;
+
+    string_view anterior;
+    size_t validas = 0;        // filas calculadas para el prefijo de 'anterior'
+    size_t muerto = SIZE_MAX;  // profundidad donde 'anterior' ya excedia maxDist
+    for (const auto& e : entradas) {
+        string_view nombre = e.first;
+        size_t comun = 0;
+        while (comun < min(nombre.size(), anterior.size()) && minuscula(nombre[comun]) == minuscula(anterior[comun])) comun++;
+        if (muerto != SIZE_MAX && comun >= muerto) {
+            // Comparte el prefijo sin salida: el resultado es el mismo
+            if (mejor[muerto - 1] <= maxDist) res.push_back({mejor[muerto - 1], e.second});
+            continue;
+        }
+
+        muerto = SIZE_MAX;
+        if (filas.size() < nombre.size() + 1) {
+            filas.resize(nombre.size() + 1, vector<int>(m + 1));
+            mejor.resize(nombre.size() + 1);
+        }
+        for (size_t i = min(comun, validas) + 1; i <= nombre.size(); ++i) {
+            vector<int>& fila = filas[i];
+            const vector<int>& arriba = filas[i - 1];
+            fila[0] = static_cast<int>(i);
+            int minimo = fila[0];
+            for (int j = 1; j <= m; ++j) {
+                int costo = minuscula(nombre[i - 1]) == minuscula(consulta[j - 1]) ? 0 : 1;
+                fila[j] = min({arriba[j] + 1, fila[j - 1] + 1, arriba[j - 1] + costo});
+                minimo = min(minimo, fila[j]);
+            }
+            mejor[i] = min(mejor[i - 1], fila[m]);
+            if (minimo > maxDist) {
+                muerto = i;
+                break;
+            }
+        }
+        validas = muerto == SIZE_MAX ? nombre.size() : muerto - 1;
+        anterior = nombre;
+        int d = mejor[validas];
+        if (d <= maxDist) res.push_back({d, e.second});
+    }
+    sort(res.begin(), res.end());
+    if (res.size() > maxResultados) res.resize(maxResultados);
+    return res;
+}
+
+float Grafo::factorPerfil(int p, float t) const {
+    const PuntoPerfil* pts = &puntosPerfil[perfiles[p].first];
+    int n = perfiles[p].second;
+    t = fmod(t, static_cast<float>(MINUTOS_DIA));
+    if (t < 0) t += MINUTOS_DIA;
+
+    if (n == 1) return pts[0].factorMil / 1000.0f;
+
+    int i = static_cast<int>(upper_bound(pts, pts + n, t, [](float x, const PuntoPerfil& q) {
+        return x < q.minuto;
+    }) - pts);
+    // Tramo entre el punto anterior y el siguiente, dando la vuelta al dia
+    const PuntoPerfil& a = pts[(i + n - 1) % n];
+    const PuntoPerfil& b = pts[i % n];
+    float ta = i == 0 ? a.minuto - MINUTOS_DIA : a.minuto;
+    float tb = i == n ? b.minuto + MINUTOS_DIA : b.minuto;
+    float f = (t - ta) / (tb - ta);
+    return (a.factorMil + f * (b.factorMil - a.factorMil)) / 1000.0f;
+}
+
+bool Grafo::esFIFO(const vector<PuntoPerfil>& pts, float w) {
+    int n = static_cast<int>(pts.size());
+    for (int i = 0; i < n; ++i) {
+        const PuntoPerfil& a = pts[i];
+        const PuntoPerfil& b = pts[(i + 1) % n];
+        float dt = i + 1 < n ? b.minuto - a.minuto : b.minuto + MINUTOS_DIA - a.minuto;
+        float dTau = w * (b.factorMil - a.factorMil) / 1000.0f;
+        if (dt > 0 && dTau < -dt) return false;
+    }
+    return true;
+}
+
+bool Grafo::admitePerfil(int from, int to, float w) const {
+    auto it = perfilArista.find(claveArista(from, to));
+    if (it == perfilArista.end()) return true;
+    auto [inicio, cantidad] = perfiles[it->second];
+    return esFIFO(vector<PuntoPerfil>(puntosPerfil.begin() + inicio, puntosPerfil.begin() + inicio + cantidad), w);
+}
+
+int Grafo::internarPerfil(const vector<PuntoPerfil>& pts) {
+    string firma(reinterpret_cast<const char*>(pts.data()), pts.size() * sizeof(PuntoPerfil));
+    auto it = perfilPorFirma.find(firma);
+    if (it != perfilPorFirma.end()) return it->second;
+    int id = static_cast<int>(perfiles.size());
+    perfiles.push_back({static_cast<int>(puntosPerfil.size()), static_cast<int>(pts.size())});
+    puntosPerfil.insert(puntosPerfil.end(), pts.begin(), pts.end());
+    perfilPorFirma.emplace(move(firma), id);
+    return id;
+}
+
+bool Grafo::parsePerfil(const string& texto, vector<PuntoPerfil>& pts) {
+    pts.clear();
+    stringstream ss(texto);
+    string punto;
+    while (getline(ss, punto, ',')) {
+        size_t sep = punto.find('*');
+        if (sep == string::npos) return false;
+        int minuto = horaAMinutos(punto.substr(0, sep));
+        float factor;
+        try {
+            factor = stof(punto.substr(sep + 1));
+        } catch (const exception&) {
+            return false;
+        }
+        // Escrito asi para que NaN (toda comparacion falsa) tambien se rechace
+        if (minuto < 0 || !(factor > 0 && factor <= 65.0f)) return false;
+        pts.push_back({static_cast<uint16_t>(minuto), static_cast<uint16_t>(lround(factor * 1000))});
+    }
+    sort(pts.begin(), pts.end(), [](const PuntoPerfil& a, const PuntoPerfil& b) { return a.minuto < b.minuto; });
+    for (size_t i = 1; i < pts.size(); ++i) {
+        if (pts[i].minuto == pts[i - 1].minuto) return false;
+    }
+    return !pts.empty();
+}
+
+string Grafo::perfilATexto(int p) const {
+    ostringstream os;
+    for (int i = 0; i < perfiles[p].second; ++i) {
+        const PuntoPerfil& q = puntosPerfil[perfiles[p].first + i];
+        if (i) os << ",";
+        os << minutosAHora(q.minuto) << "*" << q.factorMil / 1000.0f;
+    }
+    return os.str();
+}
+
+void Grafo::dfsRec(int u, vector<bool>& visit, vector<int>& orden, ConteoAlgoritmo& conteo) const {
+    visit[u] = true;
+    orden.push_back(u);
+    conteo.asentados++;
+    for (const auto& a : nodos[u].adj) {
+        int v = a.to;
+        conteo.relajadas++;
+        if (!visit[v]) {
+            dfsRec(v, visit, orden, conteo);
+        }
+    }
+}
+
+void Grafo::altaNodo(int id, string nombre) {
+    if (id < 0) return;
+    while (id >= static_cast<int>(nodos.size())) {
+        // Cada lista nueva queda ligada al pool del grafo
+        nodos.push_back(Nodo{static_cast<int>(nodos.size()), string_view(), ListaAdj(poolAdj.get())});
+    }
+    auto previo = nombreToId.find(nodos[id].nombre);
+    if (previo != nombreToId.end() && previo->second == id) nombreToId.erase(previo);
+
+    // Si el nombre ya existe se comparte la misma copia de la arena
+    auto it = nombreToId.find(nombre);
+    string_view guardado = it != nombreToId.end() ? it->first : arenaNombres.guardar(nombre);
+    nodos[id].nombre = guardado;
+    nombreToId[guardado] = id;
+    numNodos = max(numNodos, id + 1);
+    indiceSucio = true;
+}
+
+void Grafo::bajaNodo(int id) {
+    if (id >= 0 && id < static_cast<int>(nodos.size())) {
+        nodos[id].adj.clear();
+        for (auto& n : nodos) {
+            n.adj.erase(remove_if(n.adj.begin(), n.adj.end(), 
+                [id](const Arista& a){ return a.to == id; }), n.adj.end());
+        }
+        nombreToId.erase(nodos[id].nombre);
+        nodos[id].nombre = "";
+        indiceSucio = true;
+        for (auto it = perfilArista.begin(); it != perfilArista.end(); ) {
+            if ((it->first >> 32) == id || static_cast<int>(it->first & 0xffffffffLL) == id)
+                it = perfilArista.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+long Grafo::agregarAristas(vector<pair<int, Arista>>& aristas) {
+    int n = static_cast<int>(nodos.size());
+    auto invalida = [n](const pair<int, Arista>& e) {
+        return e.first < 0 || e.first >= n || e.second.to < 0 || e.second.to >= n ||
+               !isfinite(e.second.w) || e.second.w < 0;
+    };
+    size_t antes = aristas.size();
+    aristas.erase(remove_if(aristas.begin(), aristas.end(), invalida), aristas.end());
+    long descartadas = static_cast<long>(antes - aristas.size());
+    stable_sort(aristas.begin(), aristas.end(),
+                [](const pair<int, Arista>& a, const pair<int, Arista>& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < aristas.size();) {
+        size_t j = i;
+        while (j < aristas.size() && aristas[j].first == aristas[i].first) ++j;
+        ListaAdj& adj = nodos[aristas[i].first].adj;
+        size_t necesario = adj.size() + (j - i);
+        if (necesario > adj.capacity()) adj.reserve(max(necesario, 2 * adj.capacity()));
+        for (; i < j; ++i) adj.push_back(aristas[i].second);
+    }
+    return descartadas;
+}
+
+bool Grafo::asignarPerfil(int from, int to, const string& texto, string* motivo) {
+    if (from < 0 || from >= static_cast<int>(nodos.size())) return false;
+    const auto& adj = nodos[from].adj;
+    auto deArista = [to](const Arista& a) { return a.to == to; };
+    if (none_of(adj.begin(), adj.end(), deArista)) return false;
+
+    vector<PuntoPerfil> pts;
+    if (!parsePerfil(texto, pts)) {
+        if (motivo) *motivo = "Perfil invalido en la arista " + to_string(from) + " -> " + to_string(to) + ".";
+        return false;
+    }
+    // El perfil queda asociado al par (from, to): debe ser FIFO con el peso
+    // de cada arista paralela, no solo con el de la primera
+    bool fifo = all_of(adj.begin(), adj.end(), [&](const Arista& a) { return !deArista(a) || esFIFO(pts, a.w); });
+    if (!fifo) {
+        if (motivo) {
+            *motivo = "El perfil de la arista " + to_string(from) + " -> " + to_string(to)
+                    + " no cumple FIFO; se ignora.";
+        }
+        return false;
+    }
+    perfilArista[claveArista(from, to)] = internarPerfil(pts);
+    return true;
+}
+
+Ruta Grafo::rutaMasCorta(int s, int e) const {
+    const float INF = numeric_limits<float>::infinity();
+    vector<float> dist(numNodos, INF);
+    vector<int> previo(numNodos, -1);
+    vector<bool> visit(numNodos, false);
+
+    dist[s] = 0;
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+
+    MedicionOperacion med(Operacion::Dijkstra);
+    pq.push({0, s});
+    med.conteo.pushes++;
+
+    while (!pq.empty()) {
+        int u = pq.top().second;
+        pq.pop();
+
+        if (visit[u]) continue;
+        visit[u] = true;
+        med.conteo.asentados++;
+
+        for (const auto& a : nodos[u].adj) {
+            int v = a.to;
+            float w = a.w;
+            med.conteo.relajadas++;
+            if (!visit[v] && dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                previo[v] = u;
+                pq.push({dist[v], v});
+                med.conteo.pushes++;
+            }
+        }
+    }
+
+    Ruta ruta{dist[e], {}};
+    if (dist[e] != INF) {
+        for (int at = e; at != -1; at = previo[at]) {
+            ruta.camino.push_back(at);
+        }
+        reverse(ruta.camino.begin(), ruta.camino.end());
+    }
+    return ruta;
+}
+
+Ruta Grafo::dijkstraDependiente(int s, int e, int salidaMin) {
+    const float INF = numeric_limits<float>::infinity();
+    Ruta ruta{INF, {}};
+    vector<float> llegada(numNodos, INF);
+    vector<int> previo(numNodos, -1);
+    vector<bool> visit(numNodos, false);
+
+    MedicionOperacion med(Operacion::DijkstraHora);
+    llegada[s] = static_cast<float>(salidaMin);
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    pq.push({llegada[s], s});
+    med.conteo.pushes++;
+
+    while (!pq.empty()) {
+        int u = pq.top().second;
+        pq.pop();
+        if (visit[u]) continue;
+        visit[u] = true;
+        med.conteo.asentados++;
+        if (u == e) break;
+
+        for (const auto& a : nodos[u].adj) {
+            int v = a.to;
+            float t = llegada[u] + tiempoArista(u, a, llegada[u]);
+            med.conteo.relajadas++;
+            if (!visit[v] && t < llegada[v]) {
+                llegada[v] = t;
+                previo[v] = u;
+                pq.push({t, v});
+                med.conteo.pushes++;
+            }
+        }
+    }
+
+    if (llegada[e] != INF) {
+        ruta.distancia = llegada[e] - salidaMin;
+        for (int at = e; at != -1; at = previo[at]) ruta.camino.push_back(at);
+        reverse(ruta.camino.begin(), ruta.camino.end());
+    }
+    return ruta;
+}
+
+vector<NodoAlcanzado> Grafo::alcanzables(int s, vector<float> presupuestos, EspacioBusqueda& ws) const {
+    vector<NodoAlcanzado> res;
+    if (s < 0 || s >= numNodos || nodos[s].nombre.empty() || presupuestos.empty()) return res;
+    // Con un presupuesto negativo o NaN el origen (distancia 0) no cae en ninguna banda
+    if (any_of(presupuestos.begin(), presupuestos.end(), [](float p) { return !(p >= 0); })) return res;
+    sort(presupuestos.begin(), presupuestos.end());
+    float limite = presupuestos.back();
+
+    MedicionOperacion med(Operacion::Isocrona);
+    ws.preparar(numNodos);
+    auto cmp = greater<pair<float, int>>();
+    ws.fijar(s, 0);
+    ws.heap.push_back({0, s});
+    med.conteo.pushes++;
+    int banda = 0;
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), cmp);
+        auto [du, u] = ws.heap.back();
+        ws.heap.pop_back();
+        if (du > ws.distancia(u)) continue;
+
+        while (banda + 1 < static_cast<int>(presupuestos.size()) && du > presupuestos[banda]) banda++;
+        res.push_back({u, du, banda});
+        med.conteo.asentados++;
+        for (const auto& a : nodos[u].adj) {
+            float nd = du + a.w;
+            med.conteo.relajadas++;
+            if (nd <= limite && nd < ws.distancia(a.to)) {
+                ws.fijar(a.to, nd);
+                ws.heap.push_back({nd, a.to});
+                push_heap(ws.heap.begin(), ws.heap.end(), cmp);
+                med.conteo.pushes++;
+            }
+        }
+    }
+    return res;
+}
+
+vector<int> Grafo::recorridoAnchura(int s) const {
+    queue<int> q;
+    vector<bool> visit(numNodos, false);
+    visit[s] = true;
+    vector<int> orden;
+
+    MedicionOperacion med(Operacion::BFS);
+    q.push(s);
+    med.conteo.pushes++;
+
+    while (!q.empty()) {
+        int u = q.front(); 
+        q.pop();
+        orden.push_back(u);
+        med.conteo.asentados++;
+
+        for (const auto& a : nodos[u].adj) {
+            int v = a.to;
+            med.conteo.relajadas++;
+            if (!visit[v]) {
+                visit[v] = true;
+                q.push(v);
+                med.conteo.pushes++;
+            }
+        }
+    }
+    return orden;
+}
+
+vector<int> Grafo::recorridoProfundidad(int s) const {
+    vector<bool> visit(numNodos, false);
+    vector<int> orden;
+
+    MedicionOperacion med(Operacion::DFS);
+    dfsRec(s, visit, orden, med.conteo);
+    return orden;
+}
+
+vector<vector<int>> Grafo::componentesConexas() const {
+    MedicionOperacion med(Operacion::Componentes);
+    vector<bool> visit(numNodos, false);
+    vector<vector<int>> componentes;
+
+    for (int i = 0; i < numNodos; ++i) {
+        if (!visit[i] && !nodos[i].nombre.empty()) {
+            componentes.emplace_back();
+            vector<int>& comp = componentes.back();
+
+            queue<int> q;
+            visit[i] = true;
+            q.push(i);
+
+            while (!q.empty()) {
+                int u = q.front(); 
+                q.pop();
+                comp.push_back(u);
+                med.conteo.asentados++;
+
+                for (const auto& a : nodos[u].adj) {
+                    int v = a.to;
+                    med.conteo.relajadas++;
+                    if (!visit[v]) {
+                        visit[v] = true;
+                        q.push(v);
+                    }
+                }
+            }
+        }
+    }
+    return componentes;
+}
+
+vector<GradoNodo> Grafo::detectarCuellos() const {
+    MedicionOperacion med(Operacion::Cuellos);
+    vector<pair<int, int>> grados;
+
+    for (int i = 0; i < numNodos; ++i) {
+        if (!nodos[i].nombre.empty()) {
+            int gradoSalida = static_cast<int>(nodos[i].adj.size());
+            int gradoEntrada = 0;
+
+            for (int j = 0; j < numNodos; ++j) {
+                med.conteo.relajadas += nodos[j].adj.size();
+                for (const auto& a : nodos[j].adj) {
+                    if (a.to == i) gradoEntrada++;
+                }
+            }
+
+            int gradoTotal = gradoSalida + gradoEntrada;
+            grados.push_back({gradoTotal, i});
+        }
+    }
+
+    sort(grados.rbegin(), grados.rend());
+    vector<GradoNodo> res;
+    for (const auto& par : grados) {
+        int salida = static_cast<int>(nodos[par.second].adj.size());
+        res.push_back({par.second, par.first - salida, salida});
+    }
+    return res;
+}
+
+bool Grafo::cargar(const string& filename, vector<string>* advertencias) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+
+    MedicionOperacion med(Operacion::CargarRed);
+    TramoTraza lectura("cargar_red.lectura");
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+
+        stringstream ss(line);
+        string token;
+        getline(ss, token, ';');
+        string type = token;
+
+        if (type == "N") {
+            getline(ss, token, ';'); 
+            int id = stoi(token);
+            getline(ss, token, ';'); 
+            string nombre = token;
+            altaNodo(id, nombre);
+            string tokenY;
+            if (getline(ss, token, ';') && getline(ss, tokenY, ';') && !token.empty() && !tokenY.empty()) {
+                if (!fijarCoordenadas(id, stof(token), stof(tokenY)) && advertencias) {
+                    advertencias->push_back("Coordenadas del nodo " + to_string(id) + " ignoradas: no son finitas.");
+                }
+            }
+        } else if (type == "E") {
+            getline(ss, token, ';'); 
+            int from = stoi(token);
+            getline(ss, token, ';'); 
+            int to = stoi(token);
+            getline(ss, token, ';'); 
+            float w = stof(token);
+            if (!altaArista(from, to, w) && advertencias) {
+                advertencias->push_back("Arista " + to_string(from) + " -> " + to_string(to) + " rechazada"
+                                        + (!isfinite(w) ? ": el peso no es finito."
+                                           : w < 0 ? ": no se permiten pesos negativos." : ": nodo inexistente."));
+            }
+            string motivo;
+            if (getline(ss, token, ';') && !token.empty() && !asignarPerfil(from, to, token, &motivo)
+                && advertencias && !motivo.empty()) {
+                advertencias->push_back(motivo);
+            }
+        }
+    }
+    file.close();
+    lectura.cerrar();
+    {
+        TramoTraza indice("cargar_red.indice");
+        reconstruirIndiceNombres();
+    }
+    return true;
+}
+
+bool Grafo::guardar(const string& filename) const {
+    MedicionOperacion med(Operacion::GuardarRed);
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "# NODOS\n";
+    for (const auto& n : nodos) {
+        if (!n.nombre.empty()) {
+            file << "N;" << n.id << ";" << n.nombre;
+            float x, y;
+            if (getCoordenadas(n.id, x, y)) file << ";" << setprecision(9) << x << ";" << y << setprecision(6);
+            file << "\n";
+        }
+    }
+    file << "# ARISTAS\n";
+    for (int i = 0; i < numNodos; ++i) {
+        for (const auto& a : nodos[i].adj) {
+            file << "E;" << i << ";" << a.to << ";" << a.w;
+            auto it = perfilArista.find(claveArista(i, a.to));
+            if (it != perfilArista.end()) file << ";" << perfilATexto(it->second);
+            file << "\n";
+        }
+    }
+    file.close();
+    return !file.fail();
+}
+
+vector<UsoMemoria> Grafo::reporteMemoria() const {
+    vector<UsoMemoria> rep;
+
+    UsoMemoria n{"Nodos"};
+    contarVector(n, nodos);
+    contarVector(n, coordenadas);
+    rep.push_back(n);
+
+    UsoMemoria adj{"Adyacencia (pool)"};
+    for (const auto& nodo : nodos) adj.vivos += nodo.adj.size() * sizeof(Arista);
+    adj.holgura = heapAdj->getBytes() > adj.vivos ? heapAdj->getBytes() - adj.vivos : 0;
+    adj.asignaciones = heapAdj->getBloques();
+    rep.push_back(adj);
+
+    UsoMemoria nom{"Nombres (arena)"};
+    size_t referenciados = 0;
+    for (const auto& par : nombreToId) referenciados += par.first.size();
+    arenaNombres.contarMemoria(nom, referenciados);
+    rep.push_back(nom);
+
+    UsoMemoria mapa{"nombreToId"};
+    contarHash(mapa, nombreToId);
+    rep.push_back(mapa);
+
+    UsoMemoria idx{"Indice de nombres"};
+    indiceNombres.contarMemoria(idx);
+    rep.push_back(idx);
+
+    UsoMemoria perf{"Perfiles"};
+    contarVector(perf, puntosPerfil);
+    contarVector(perf, perfiles);
+    contarHash(perf, perfilPorFirma);
+    for (const auto& par : perfilPorFirma) contarString(perf, par.first);
+    contarHash(perf, perfilArista);
+    rep.push_back(perf);
+
+    UsoMemoria ws{"Espacio de busqueda"};
+    contarVector(ws, espacio.dist);
+    contarVector(ws, espacio.marca);
+    contarVector(ws, espacio.heap);
+    rep.push_back(ws);
+    return rep;
+}
+
+void Grafo::liberarHolgura() {
+    auto nuevoHeap = make_unique<RecursoContado>();
+    auto nuevoPool = make_unique<pmr::unsynchronized_pool_resource>(nuevoHeap.get());
+    ArenaNombres nuevaArena;
+    unordered_map<string_view, int> nuevoMapa;
+    nuevoMapa.reserve(nombreToId.size());
+    {
+        vector<Nodo> nuevos;
+        nuevos.reserve(nodos.size());
+        for (const auto& n : nodos) {
+            nuevos.push_back(Nodo{n.id, string_view(), ListaAdj(n.adj.begin(), n.adj.end(), nuevoPool.get())});
+            if (n.nombre.empty()) continue;
+            // Cada nombre se copia una vez; -1 marca nombres sin entrada en el mapa
+            auto it = nuevoMapa.find(n.nombre);
+            if (it == nuevoMapa.end()) {
+                auto viejo = nombreToId.find(n.nombre);
+                int id = viejo != nombreToId.end() ? viejo->second : -1;
+                it = nuevoMapa.emplace(nuevaArena.guardar(n.nombre), id).first;
+            }
+            nuevos.back().nombre = it->first;
+        }
+        for (auto it = nuevoMapa.begin(); it != nuevoMapa.end(); ) {
+            it = it->second == -1 ? nuevoMapa.erase(it) : next(it);
+        }
+        // Los nodos viejos se destruyen aqui, antes que su pool
+        nodos.swap(nuevos);
+    }
+    poolAdj = move(nuevoPool);
+    heapAdj = move(nuevoHeap);
+    nombreToId = move(nuevoMapa);
+    arenaNombres = move(nuevaArena);
+    reconstruirIndiceNombres();
+    indiceNombres.liberarHolgura();
+
+    coordenadas.shrink_to_fit();
+    puntosPerfil.shrink_to_fit();
+    perfiles.shrink_to_fit();
+    ajustarCubetas(perfilPorFirma);
+    ajustarCubetas(perfilArista);
+    espacio = EspacioBusqueda();
+}
+
+}  // namespace trafico
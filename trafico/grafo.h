@@ -0,0 +1,438 @@
+// Red vial: nodos, aristas, perfiles por hora y algoritmos basicos.
+#ifndef TRAFICO_GRAFO_H
+#define TRAFICO_GRAFO_H
+
+#include "metricas.h"
+
+namespace trafico {
+
+// Estructuras para el Grafo
+struct Arista {
+    int to;
+    float w;
+};
+
+// Uso de memoria de un componente: bytes en uso, bytes reservados sin usar
+// (holgura de capacidad) y bloques pedidos al heap. Para los contenedores
+// basados en nodos es una estimacion con la disposicion de libstdc++.
+struct UsoMemoria {
+    std::string componente;
+    size_t vivos = 0;
+    size_t holgura = 0;
+    size_t asignaciones = 0;
+};
+
+template <typename T, typename A>
+void contarVector(UsoMemoria& u, const std::vector<T, A>& v) {
+    u.vivos += v.size() * sizeof(T);
+    u.holgura += (v.capacity() - v.size()) * sizeof(T);
+    if (v.capacity() > 0) u.asignaciones++;
+}
+
+// Las cadenas cortas caben en el propio objeto (SSO) y no piden memoria
+inline void contarString(UsoMemoria& u, const std::string& s) {
+    if (s.capacity() <= std::string().capacity()) return;
+    u.vivos += s.size() + 1;
+    u.holgura += s.capacity() - s.size();
+    u.asignaciones++;
+}
+
+// Tabla hash: un nodo por elemento (enlace, valor y hash guardado) mas el
+// arreglo de buckets; los buckets por encima del factor de carga son holgura
+template <typename C>
+void contarHash(UsoMemoria& u, const C& c) {
+    u.vivos += c.size() * (sizeof(void*) + sizeof(typename C::value_type) + sizeof(size_t));
+    u.asignaciones += c.size();
+    if (c.bucket_count() > 1) {
+        size_t necesarios = static_cast<size_t>(ceil(c.size() / c.max_load_factor()));
+        necesarios = std::min(necesarios, c.bucket_count());
+        u.vivos += necesarios * sizeof(void*);
+        u.holgura += (c.bucket_count() - necesarios) * sizeof(void*);
+        u.asignaciones++;
+    }
+}
+
+// Reduce las cubetas al minimo para el factor de carga; una tabla vacia se
+// reemplaza por una nueva porque rehash(0) le dejaria un arreglo propio
+template <typename C>
+void ajustarCubetas(C& c) {
+    if (c.empty()) C().swap(c);
+    else c.rehash(0);
+}
+
+// Recurso que cuenta los bytes y bloques que un pool pide al heap general
+class RecursoContado : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* base;
+    size_t bytes = 0;
+    size_t bloques = 0;
+
+    void* do_allocate(size_t n, size_t alineacion) override {
+        void* p = base->allocate(n, alineacion);
+        bytes += n;
+        bloques++;
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t n, size_t alineacion) override {
+        base->deallocate(p, n, alineacion);
+        bytes -= n;
+        bloques--;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& otro) const noexcept override { return this == &otro; }
+
+public:
+    explicit RecursoContado(std::pmr::memory_resource* b = std::pmr::new_delete_resource()) : base(b) {}
+
+    size_t getBytes() const { return bytes; }
+    size_t getBloques() const { return bloques; }
+};
+
+// Las listas de adyacencia de un grafo se sirven desde un pool propio
+// (std::pmr) en lugar de pedir cada crecimiento al heap general
+using ListaAdj = std::pmr::vector<Arista>;
+
+struct Nodo {
+    int id;
+    std::string_view nombre;  // apunta a la arena de nombres del grafo
+    ListaAdj adj;
+};
+
+// Arena de nombres: cada nombre se copia una sola vez en bloques contiguos
+// y se referencia con string_view. Los bloques no se mueven ni se liberan
+// hasta destruir la arena, asi que las vistas siguen siendo validas.
+class ArenaNombres {
+private:
+    static const size_t TAM_BLOQUE = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> bloques;
+    char* bloqueActual = nullptr;
+    size_t usadoBloque = TAM_BLOQUE;
+    size_t bytesUsados = 0;
+    size_t bytesReservados = 0;
+
+public:
+    std::string_view guardar(std::string_view s);
+
+    size_t getBytesUsados() const { return bytesUsados; }
+    size_t getBytesReservados() const { return bytesReservados; }
+    size_t getNumBloques() const { return bloques.size(); }
+
+    // 'referenciados' son los bytes de nombres que siguen en uso; el resto de
+    // lo usado son nombres de nodos dados de baja o renombrados
+    void contarMemoria(UsoMemoria& u, size_t referenciados) const {
+        u.vivos += referenciados;
+        u.holgura += bytesReservados - referenciados;
+        u.asignaciones += bloques.size();
+        contarVector(u, bloques);
+    }
+};
+
+// Punto de un perfil de tiempo de viaje: a partir de 'minuto' el tiempo de la
+// arista es w * factorMil / 1000, interpolando linealmente entre puntos
+struct PuntoPerfil {
+    uint16_t minuto;
+    uint16_t factorMil;
+};
+
+// Resultado de una consulta de ruta
+struct Ruta {
+    float distancia;
+    std::vector<int> camino;
+};
+
+// Grados de un nodo para el reporte de cuellos de botella
+struct GradoNodo {
+    int id;
+    int entrada;
+    int salida;
+};
+
+// Nodo alcanzado en una busqueda acotada; 'banda' es el indice del menor
+// presupuesto que lo cubre
+struct NodoAlcanzado {
+    int id;
+    float distancia;
+    int banda;
+};
+
+// Espacio de trabajo reutilizable para busquedas acotadas: las distancias se
+// invalidan con una marca de generacion en lugar de reinicializar el arreglo
+struct EspacioBusqueda {
+    std::vector<float> dist;
+    std::vector<unsigned> marca;
+    std::vector<std::pair<float, int>> heap;
+    unsigned actual = 0;
+
+    void preparar(int n);
+
+    float distancia(int v) const {
+        return marca[v] == actual ? dist[v] : std::numeric_limits<float>::infinity();
+    }
+
+    void fijar(int v, float d) {
+        marca[v] = actual;
+        dist[v] = d;
+    }
+};
+
+// Indice de nombres para busquedas por prefijo y aproximadas, sin distinguir
+// mayusculas. Es un arreglo de (nombre, id) ordenado que se construye de una
+// vez; la busqueda aproximada recorre el arreglo como si fuera un trie,
+// reutilizando las filas de la distancia de edicion del prefijo comun con el
+// nombre anterior y saltando los prefijos que ya exceden la distancia.
+class IndiceNombres {
+private:
+    std::vector<std::pair<std::string_view, int>> entradas;
+
+    static char minuscula(char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); }
+
+    static bool menor(std::string_view a, std::string_view b);
+
+    static bool empiezaCon(std::string_view s, std::string_view prefijo) {
+        if (prefijo.size() > s.size()) return false;
+        for (size_t i = 0; i < prefijo.size(); ++i) {
+            if (minuscula(s[i]) != minuscula(prefijo[i])) return false;
+        }
+        return true;
+    }
+
+public:
+    template <typename It>
+    void construir(It primero, It ultimo) {
+        entradas.assign(primero, ultimo);
+        std::sort(entradas.begin(), entradas.end(), [](const std::pair<std::string_view, int>& a, const std::pair<std::string_view, int>& b) {
+            return menor(a.first, b.first);
+        });
+    }
+
+    size_t size() const { return entradas.size(); }
+
+    void contarMemoria(UsoMemoria& u) const { contarVector(u, entradas); }
+    void liberarHolgura() { entradas.shrink_to_fit(); }
+
+    std::vector<int> porPrefijo(std::string_view prefijo, size_t maxResultados) const;
+
+    // Nombres cuyo inicio esta a distancia de edicion <= maxDist de la consulta
+    // (sirve para nombres escritos a medias y con errores), como pares
+    // (distancia, id) ordenados
+    std::vector<std::pair<int, int>> aproximados(std::string_view consulta, int maxDist, size_t maxResultados) const;
+};
+
+class Grafo {
+private:
+    // El pool y la arena se declaran antes que los nodos para destruirse despues
+    std::unique_ptr<RecursoContado> heapAdj;
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> poolAdj;
+    ArenaNombres arenaNombres;
+    std::vector<Nodo> nodos;
+    std::unordered_map<std::string_view, int> nombreToId;
+    int numNodos;
+
+    IndiceNombres indiceNombres;
+    bool indiceSucio = true;
+
+    // Perfiles de tiempo: los puntos de todos los perfiles van seguidos en un
+    // solo arreglo y perfiles iguales se comparten. Solo las aristas con
+    // perfil aparecen en perfilArista (clave origen/destino).
+    std::vector<PuntoPerfil> puntosPerfil;
+    std::vector<std::pair<int, int>> perfiles;  // (inicio, cantidad) en puntosPerfil
+    std::unordered_map<std::string, int> perfilPorFirma;
+    std::unordered_map<long long, int> perfilArista;
+
+    // Coordenadas opcionales (N;id;nombre;x;y); vacio si la red no las trae
+    std::vector<std::pair<float, float>> coordenadas;
+
+    EspacioBusqueda espacio;
+
+    static long long claveArista(int from, int to) {
+        return (static_cast<long long>(from) << 32) | static_cast<unsigned int>(to);
+    }
+
+    // Factor del perfil p en el minuto t (periodico cada 24 horas)
+    float factorPerfil(int p, float t) const;
+
+    // FIFO: salir mas tarde nunca hace llegar antes, es decir la pendiente del
+    // tiempo de viaje w*f(t) nunca es menor que -1 en ningun tramo
+    static bool esFIFO(const std::vector<PuntoPerfil>& pts, float w);
+
+    // Si from->to ya tiene perfil, si este sigue siendo FIFO con el peso w
+    bool admitePerfil(int from, int to, float w) const;
+
+    int internarPerfil(const std::vector<PuntoPerfil>& pts);
+
+    static bool parsePerfil(const std::string& texto, std::vector<PuntoPerfil>& pts);
+
+    std::string perfilATexto(int p) const;
+
+    void dfsRec(int u, std::vector<bool>& visit, std::vector<int>& orden, ConteoAlgoritmo& conteo) const;
+
+public:
+    Grafo()
+        : heapAdj(std::make_unique<RecursoContado>()),
+          poolAdj(std::make_unique<std::pmr::unsynchronized_pool_resource>(heapAdj.get())),
+          numNodos(0) {}
+
+    void altaNodo(int id, std::string nombre);
+
+    // Reserva espacio para n nodos antes de una carga masiva
+    void reservarNodos(int n) {
+        nodos.reserve(n);
+        nombreToId.reserve(n);
+    }
+
+    void bajaNodo(int id);
+
+    // Devuelve false si algun nodo esta fuera de rango o el peso es negativo o no finito
+    bool altaArista(int from, int to, float w) {
+        if (from < 0 || from >= static_cast<int>(nodos.size()) || to < 0 || to >= static_cast<int>(nodos.size()) ||
+            !std::isfinite(w) || w < 0) {
+            return false;
+        }
+        // Una arista paralela comparte el perfil del par (from, to)
+        if (!perfilArista.empty() && !admitePerfil(from, to, w)) return false;
+        nodos[from].adj.push_back({to, w});
+        return true;
+    }
+
+    // Agrega un bloque de aristas (origen, arista) agrupado por origen: cada
+    // lista crece a lo sumo una vez por bloque y se recorre en orden de nodo.
+    // Conserva el orden de las aristas de un mismo origen. Devuelve cuantas
+    // se descartaron por nodos inexistentes o pesos negativos o no finitos.
+    long agregarAristas(std::vector<std::pair<int, Arista>>& aristas);
+
+    void bajaArista(int from, int to) {
+        if (from >= 0 && from < static_cast<int>(nodos.size())) {
+            nodos[from].adj.erase(std::remove_if(nodos[from].adj.begin(), nodos[from].adj.end(), 
+                [to](const Arista& a){ return a.to == to; }), nodos[from].adj.end());
+            perfilArista.erase(claveArista(from, to));
+        }
+    }
+
+    // Asigna a la arista from->to un perfil "HH:MM*factor,..." (factor sobre w).
+    // Aplica a todas las aristas paralelas entre los mismos nodos y debe ser
+    // FIFO con el peso de cada una (tambien con las que se agreguen). Si el perfil
+    // se rechaza y se indica 'motivo', ahi queda la explicacion.
+    bool asignarPerfil(int from, int to, const std::string& texto, std::string* motivo = nullptr);
+
+    // Tiempo de recorrido de la arista saliendo en el minuto t
+    float tiempoArista(int from, const Arista& a, float t) const {
+        if (perfilArista.empty()) return a.w;
+        auto it = perfilArista.find(claveArista(from, a.to));
+        return it == perfilArista.end() ? a.w : a.w * factorPerfil(it->second, t);
+    }
+
+    int getNumPerfiles() const { return static_cast<int>(perfiles.size()); }
+    int getNumAristasConPerfil() const { return static_cast<int>(perfilArista.size()); }
+
+    // Ruta mas corta con los pesos estaticos; es la referencia contra la que
+    // se comparan los demas motores
+    Ruta rutaMasCorta(int s, int e) const;
+
+    // Dijkstra dependiente del tiempo: la etiqueta de cada nodo es la hora de
+    // llegada y cada arista se evalua a la hora en que se entra en ella. Con
+    // perfiles FIFO esto da la ruta de llegada mas temprana.
+    Ruta dijkstraDependiente(int s, int e, int salidaMin);
+
+    // Nodos alcanzables desde s con costo <= max(presupuestos). Una sola
+    // busqueda cubre todos los presupuestos (p. ej. 4, 8 y 12 minutos); cada
+    // nodo se etiqueta con la primera banda que lo alcanza. Los resultados
+    // salen en orden de distancia; vacio si algun presupuesto es negativo o NaN.
+    std::vector<NodoAlcanzado> alcanzables(int s, std::vector<float> presupuestos, EspacioBusqueda& ws) const;
+
+    // Variantes que reutilizan el espacio de trabajo propio del grafo
+    std::vector<NodoAlcanzado> alcanzables(int s, const std::vector<float>& presupuestos) {
+        return alcanzables(s, presupuestos, espacio);
+    }
+
+    std::vector<NodoAlcanzado> alcanzables(int s, float presupuesto) {
+        return alcanzables(s, std::vector<float>{presupuesto}, espacio);
+    }
+
+    // Orden de visita en anchura desde s
+    std::vector<int> recorridoAnchura(int s) const;
+
+    // Orden de visita en profundidad desde s
+    std::vector<int> recorridoProfundidad(int s) const;
+
+    // Nodos de cada componente, en el orden en que se alcanzan siguiendo las
+    // aristas salientes desde el menor ID no visitado
+    std::vector<std::vector<int>> componentesConexas() const;
+
+    // Grado de entrada y salida de cada nodo, de mayor a menor grado total
+    std::vector<GradoNodo> detectarCuellos() const;
+
+    // Devuelve false si no se pudo abrir el archivo. Las aristas y perfiles
+    // rechazados se describen en 'advertencias' si se indica.
+    bool cargar(const std::string& filename, std::vector<std::string>* advertencias = nullptr);
+
+    bool guardar(const std::string& filename) const;
+
+    int getIdByName(const std::string& name) const { 
+        auto it = nombreToId.find(name);
+        return it != nombreToId.end() ? it->second : -1;
+    }
+
+    bool existe(int id) const { return id >= 0 && id < numNodos && !nodos[id].nombre.empty(); }
+
+    // NaN marca "sin coordenadas": se rechazan las no finitas (false)
+    bool fijarCoordenadas(int id, float x, float y) {
+        if (id < 0 || id >= static_cast<int>(nodos.size()) || !std::isfinite(x) || !std::isfinite(y)) return false;
+        const float NaN = std::numeric_limits<float>::quiet_NaN();
+        if (coordenadas.size() < nodos.size()) coordenadas.resize(nodos.size(), {NaN, NaN});
+        coordenadas[id] = {x, y};
+        return true;
+    }
+
+    bool tieneCoordenadas() const { return !coordenadas.empty(); }
+
+    bool getCoordenadas(int id, float& x, float& y) const {
+        if (id < 0 || id >= static_cast<int>(coordenadas.size()) || std::isnan(coordenadas[id].first)) return false;
+        x = coordenadas[id].first;
+        y = coordenadas[id].second;
+        return true;
+    }
+
+    // Construye el indice de nombres de una vez (tras cargar la red); las
+    // busquedas lo reconstruyen solas si hubo altas o bajas de nodos
+    void reconstruirIndiceNombres() {
+        indiceNombres.construir(nombreToId.begin(), nombreToId.end());
+        indiceSucio = false;
+    }
+
+    std::vector<int> buscarPorPrefijo(const std::string& prefijo, size_t maxResultados = 20) {
+        MedicionOperacion med(Operacion::BuscarNombre);
+        if (indiceSucio) reconstruirIndiceNombres();
+        return indiceNombres.porPrefijo(prefijo, maxResultados);
+    }
+
+    std::vector<std::pair<int, int>> buscarAproximado(const std::string& nombre, int maxDist, size_t maxResultados = 20) {
+        MedicionOperacion med(Operacion::BuscarNombre);
+        if (indiceSucio) reconstruirIndiceNombres();
+        return indiceNombres.aproximados(nombre, maxDist, maxResultados);
+    }
+
+    std::string getNameById(int id) const {
+        if (id >= 0 && id < static_cast<int>(nodos.size()))
+            return std::string(nodos[id].nombre);
+        return "";
+    }
+
+    int getNumNodos() const { return numNodos; }
+    const std::vector<Nodo>& getNodos() const { return nodos; }
+    const ArenaNombres& getArenaNombres() const { return arenaNombres; }
+
+    // Memoria por componente. La adyacencia se mide por lo que el pool pidio
+    // al heap: todo lo que no son aristas vivas es holgura (capacidad de mas
+    // en las listas y bloques libres dentro del pool).
+    std::vector<UsoMemoria> reporteMemoria() const;
+
+    // Devuelve la holgura al sistema: las listas se copian con su tamano
+    // exacto a un pool nuevo (el viejo se libera entero), los nombres vivos
+    // pasan a una arena nueva y se reajustan tablas y arreglos.
+    void liberarHolgura();
+};
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,138 @@
+#include "importador.h"
+
+using namespace std;
+
+namespace trafico {
+
+bool ImportadorRed::leerEntero(const char*& p, long long& x) {
+    p = saltarSeparadores(p);
+    char* fin;
+    x = strtoll(p, &fin, 10);
+    if (fin == p) return false;
+    p = fin;
+    return true;
+}
+
+bool ImportadorRed::leerReal(const char*& p, float& x) {
+    p = saltarSeparadores(p);
+    char* fin;
+    x = strtof(p, &fin);
+    // nan/inf (o un desborde) romperian el orden de Dijkstra y el JSON de los reportes
+    if (fin == p || !isfinite(x)) return false;
+    p = fin;
+    return true;
+}
+
+bool ImportadorRed::dimacs(const string& archivo, const string& archivoCoordenadas) {
+    ifstream file(archivo);
+    if (!file.is_open()) {
+        error = "No se pudo abrir el archivo " + archivo;
+        return false;
+    }
+    MedicionOperacion med(Operacion::ImportarRed);
+    TramoTraza tramo("importar.dimacs");
+    string line;
+    long long n = -1, u, v;
+    float w;
+    while (getline(file, line)) {
+        lineas++;
+        const char* p = line.c_str();
+        if (line[0] == 'a') {
+            p++;
+            if (n >= 0 && leerEntero(p, u) && leerEntero(p, v) && leerReal(p, w)
+                && u >= 1 && u <= n && v >= 1 && v <= n) {
+                arista(base + static_cast<int>(u - 1), base + static_cast<int>(v - 1), w);
+            } else {
+                invalidas++;
+            }
+        } else if (line[0] == 'p' && n < 0) {
+            // "p sp <nodos> <arcos>": se crean todos los nodos de una vez
+            string tipo;
+            long long m = 0;
+            istringstream ss(line.substr(1));
+            ss >> tipo >> n >> m;
+            if (!ss || n < 0 || n > numeric_limits<int>::max() - base) {
+                error = "Encabezado DIMACS invalido: " + line;
+                return false;
+            }
+            g.reservarNodos(base + static_cast<int>(n));
+            for (long long i = 1; i <= n; ++i) g.altaNodo(base + static_cast<int>(i - 1), "n" + to_string(i));
+        }
+    }
+    if (n < 0) {
+        error = "Falta la linea 'p sp' en " + archivo;
+        return false;
+    }
+
+    if (!archivoCoordenadas.empty()) {
+        ifstream co(archivoCoordenadas);
+        if (!co.is_open()) {
+            advertencia = "No se pudo abrir " + archivoCoordenadas;
+        }
+        float x, y;
+        while (getline(co, line)) {
+            const char* p = line.c_str();
+            if (line[0] != 'v') continue;
+            p++;
+            if (leerEntero(p, u) && leerReal(p, x) && leerReal(p, y) && u >= 1 && u <= n) {
+                g.fijarCoordenadas(base + static_cast<int>(u - 1), x, y);
+            }
+        }
+    }
+    terminar();
+    return true;
+}
+
+bool ImportadorRed::osm(const string& archivo, bool dobleSentido) {
+    ifstream file(archivo);
+    if (!file.is_open()) {
+        error = "No se pudo abrir el archivo " + archivo;
+        return false;
+    }
+    MedicionOperacion med(Operacion::ImportarRed);
+    TramoTraza tramo("importar.osm");
+    unordered_map<long long, int> ids;
+    auto interno = [&](long long externo) {
+        auto [it, nuevo] = ids.try_emplace(externo, base + static_cast<int>(ids.size()));
+        if (nuevo) g.altaNodo(it->second, "osm" + to_string(externo));
+        return it->second;
+    };
+
+    string line;
+    long long u, v;
+    float w;
+    while (getline(file, line)) {
+        lineas++;
+        const char* p = saltarSeparadores(line.c_str());
+        if (!isdigit(static_cast<unsigned char>(*p)) && *p != '-') continue;
+        if (!leerEntero(p, u) || !leerEntero(p, v) || !leerReal(p, w) || w < 0) {
+            invalidas++;
+            continue;
+        }
+        int from = interno(u), to = interno(v);
+        arista(from, to, w);
+        if (dobleSentido) arista(to, from, w);
+    }
+    terminar();
+    return true;
+}
+
+ResultadoCarga cargarRedYVehiculos(Grafo& g, HashTable& ht, const string& archivoRed, const string& archivoVehiculos) {
+    ResultadoCarga res;
+    auto inicio = chrono::steady_clock::now();
+    thread lectorVehiculos([&]() {
+        res.vehiculosLeidos = ht.cargar(archivoVehiculos, res.vehiculos);
+        res.segVehiculos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    });
+    res.redLeida = g.cargar(archivoRed, &res.advertenciasRed);
+    res.segRed = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    lectorVehiculos.join();
+
+    if (res.vehiculosLeidos) {
+        res.invalidos = ht.validarContra(g, max(static_cast<int>(thread::hardware_concurrency()), 1));
+    }
+    res.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return res;
+}
+
+}  // namespace trafico
@@ -0,0 +1,91 @@
+// Importacion de redes externas y carga de archivos.
+#ifndef TRAFICO_IMPORTADOR_H
+#define TRAFICO_IMPORTADOR_H
+
+#include "vehiculos.h"
+
+namespace trafico {
+
+// Importa redes externas al Grafo leyendo el archivo linea por linea:
+//  - DIMACS (reto de caminos minimos): "p sp n m" y arcos "a u v w" con IDs
+//    desde 1; opcionalmente el .co con "v id x y" para las coordenadas.
+//  - Listas de aristas derivadas de OSM: "u v longitud" separados por
+//    espacios, comas o punto y coma, con IDs de 64 bits que se renumeran en
+//    orden de aparicion. Las lineas que no empiezan con un numero se ignoran.
+// Los nodos se agregan despues de los existentes y reciben un nombre generado
+// a partir de su ID externo ("n<id>" u "osm<id>"). Las aristas se acumulan en
+// bloques de tamano fijo, asi que la memoria adicional la acota el bloque y
+// no el numero de arcos del archivo.
+class ImportadorRed {
+public:
+    static const size_t TAM_BLOQUE = 1 << 18;
+
+    long lineas = 0;
+    long invalidas = 0;     // lineas de arco que no se pudieron interpretar
+    long arcos = 0;
+    long descartadas = 0;   // arcos hacia nodos inexistentes o con peso negativo
+    std::string error;           // motivo cuando dimacs() u osm() devuelven false
+    std::string advertencia;     // problema no fatal (p. ej. falta el .co)
+
+private:
+    Grafo& g;
+    int base;
+    std::vector<std::pair<int, Arista>> bloque;
+
+    static const char* saltarSeparadores(const char* p) {
+        while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';' || *p == '\r') ++p;
+        return p;
+    }
+
+    static bool leerEntero(const char*& p, long long& x);
+
+    // Rechaza valores no finitos (nan, inf o fuera del rango de float)
+    static bool leerReal(const char*& p, float& x);
+
+    void vaciar() {
+        descartadas += g.agregarAristas(bloque);
+        bloque.clear();
+    }
+
+    void arista(int from, int to, float w) {
+        bloque.push_back({from, {to, w}});
+        arcos++;
+        if (bloque.size() == TAM_BLOQUE) vaciar();
+    }
+
+    void terminar() {
+        vaciar();
+        TramoTraza indice("importar.indice");
+        g.reconstruirIndiceNombres();
+    }
+
+public:
+    explicit ImportadorRed(Grafo& grafo) : g(grafo), base(grafo.getNumNodos()) {
+        bloque.reserve(TAM_BLOQUE);
+    }
+
+    bool dimacs(const std::string& archivo, const std::string& archivoCoordenadas);
+
+    bool osm(const std::string& archivo, bool dobleSentido);
+};
+
+// Resultado de cargar una red y sus vehiculos
+struct ResultadoCarga {
+    bool redLeida = false;
+    bool vehiculosLeidos = false;
+    int vehiculos = 0;
+    std::vector<std::string> advertenciasRed;     // aristas y perfiles rechazados
+    std::vector<std::string> invalidos;           // vehiculos con origen o destino inexistente
+    double segundos = 0;
+    double segRed = 0;
+    double segVehiculos = 0;
+};
+
+// Lee la red en el hilo actual y los vehiculos en otro, de modo que el
+// arranque tarda lo que el mas lento de los dos archivos. Al final revisa en
+// paralelo que los origenes y destinos de los vehiculos existan en la red.
+ResultadoCarga cargarRedYVehiculos(Grafo& g, HashTable& ht, const std::string& archivoRed, const std::string& archivoVehiculos);
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,227 @@
+#include "metricas.h"
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace trafico {
+
+uint64_t HistogramaLatencia::percentil(double p) const {
+    uint64_t n = getTotal();
+    if (n == 0) return 0;
+    uint64_t objetivo = max<uint64_t>(1, static_cast<uint64_t>(ceil(p / 100.0 * n)));
+    uint64_t acumulado = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        acumulado += buckets[i].load(memory_order_relaxed);
+        if (acumulado >= objetivo) return min(techo(i), getMaximo());
+    }
+    return getMaximo();
+}
+
+string Metricas::formatoDuracion(double ns) {
+    ostringstream ss;
+    ss << fixed << setprecision(ns < 1e3 ? 0 : 2);
+    if (ns < 1e3) ss << ns << "ns";
+    else if (ns < 1e6) ss << ns / 1e3 << "us";
+    else if (ns < 1e9) ss << ns / 1e6 << "ms";
+    else ss << ns / 1e9 << "s";
+    return ss.str();
+}
+
+void Metricas::registrar(Operacion op, uint64_t ns, const ConteoAlgoritmo& c) {
+    MetricaOperacion& m = ops[static_cast<int>(op)];
+    m.latencia.registrar(ns);
+    if (c.asentados) m.asentados.fetch_add(c.asentados, memory_order_relaxed);
+    if (c.relajadas) m.relajadas.fetch_add(c.relajadas, memory_order_relaxed);
+    if (c.pushes) m.pushes.fetch_add(c.pushes, memory_order_relaxed);
+    if (c.sondeos) m.sondeos.fetch_add(c.sondeos, memory_order_relaxed);
+}
+
+void Metricas::reiniciar() {
+    for (auto& m : ops) {
+        m.latencia.reiniciar();
+        m.asentados.store(0, memory_order_relaxed);
+        m.relajadas.store(0, memory_order_relaxed);
+        m.pushes.store(0, memory_order_relaxed);
+        m.sondeos.store(0, memory_order_relaxed);
+    }
+}
+
+void Metricas::mostrar(ostream& out) const {
+    out << "\n========== RESUMEN DE METRICAS ==========\n";
+    out << left << setw(16) << "Operacion" << right << setw(10) << "Llamadas"
+        << setw(10) << "Prom" << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "Max"
+        << setw(12) << "Asentados" << setw(12) << "Relajadas" << setw(12) << "Pushes"
+        << setw(12) << "Sondeos" << endl;
+    int activas = 0;
+    for (int i = 0; i < NUM_OPERACIONES; ++i) {
+        const MetricaOperacion& m = ops[i];
+        if (m.latencia.getTotal() == 0) continue;
+        activas++;
+        out << left << setw(16) << NOMBRES_OPERACION[i] << right << setw(10) << m.latencia.getTotal()
+            << setw(10) << formatoDuracion(m.latencia.promedio())
+            << setw(10) << formatoDuracion(m.latencia.percentil(50))
+            << setw(10) << formatoDuracion(m.latencia.percentil(99))
+            << setw(10) << formatoDuracion(m.latencia.getMaximo())
+            << setw(12) << m.asentados.load(memory_order_relaxed)
+            << setw(12) << m.relajadas.load(memory_order_relaxed)
+            << setw(12) << m.pushes.load(memory_order_relaxed)
+            << setw(12) << m.sondeos.load(memory_order_relaxed) << endl;
+    }
+    if (activas == 0) out << "Sin operaciones registradas.\n";
+    out << left;
+}
+
+void Metricas::volcarJSON(ostream& out) const {
+    out << "{\n  \"operaciones\": {";
+    bool primero = true;
+    for (int i = 0; i < NUM_OPERACIONES; ++i) {
+        const MetricaOperacion& m = ops[i];
+        if (m.latencia.getTotal() == 0) continue;
+        out << (primero ? "\n" : ",\n");
+        primero = false;
+        out << "    \"" << NOMBRES_OPERACION[i] << "\": {"
+            << "\"llamadas\": " << m.latencia.getTotal()
+            << ", \"latencia_ns\": {\"promedio\": " << static_cast<uint64_t>(m.latencia.promedio())
+            << ", \"p50\": " << m.latencia.percentil(50)
+            << ", \"p90\": " << m.latencia.percentil(90)
+            << ", \"p99\": " << m.latencia.percentil(99)
+            << ", \"p999\": " << m.latencia.percentil(99.9)
+            << ", \"max\": " << m.latencia.getMaximo() << "}"
+            << ", \"nodos_asentados\": " << m.asentados.load(memory_order_relaxed)
+            << ", \"aristas_relajadas\": " << m.relajadas.load(memory_order_relaxed)
+            << ", \"heap_pushes\": " << m.pushes.load(memory_order_relaxed)
+            << ", \"sondeos_hash\": " << m.sondeos.load(memory_order_relaxed) << "}";
+    }
+    out << (primero ? "" : "\n  ") << "}\n}\n";
+}
+
+Trazador::BuferHilo& Trazador::buferPropio() {
+    thread_local shared_ptr<BuferHilo> propio;
+    if (!propio) {
+        propio = make_shared<BuferHilo>();
+        propio->tid = siguienteTid.fetch_add(1);
+        lock_guard<mutex> lock(mBufers);
+        bufers.push_back(propio);
+    }
+    return *propio;
+}
+
+void Trazador::escribirConteo(ostream& out, const ConteoAlgoritmo& c) {
+    const pair<const char*, uint64_t> campos[] = {
+        {"nodos_asentados", c.asentados}, {"aristas_relajadas", c.relajadas},
+        {"heap_pushes", c.pushes}, {"sondeos_hash", c.sondeos}
+    };
+    bool primero = true;
+    for (const auto& [clave, valor] : campos) {
+        if (!valor) continue;
+        out << (primero ? "" : ",") << "\"" << clave << "\":" << valor;
+        primero = false;
+    }
+}
+
+void Trazador::iniciar(size_t limite) {
+    lock_guard<mutex> lock(mBufers);
+    // Se olvidan los bufers de hilos que ya terminaron
+    bufers.erase(remove_if(bufers.begin(), bufers.end(),
+                           [](const shared_ptr<BuferHilo>& b) { return b.use_count() == 1; }),
+                 bufers.end());
+    for (auto& b : bufers) {
+        lock_guard<mutex> lb(b->m);
+        b->eventos.clear();
+    }
+    maxEventos.store(limite, memory_order_relaxed);
+    registrados.store(0, memory_order_relaxed);
+    descartados.store(0, memory_order_relaxed);
+    origenNs.store(ahoraNs(chrono::steady_clock::now()), memory_order_relaxed);
+    activo.store(true, memory_order_release);
+}
+
+void Trazador::registrar(const char* nombre, const char* categoria, chrono::steady_clock::time_point inicio,
+               chrono::steady_clock::time_point fin, const ConteoAlgoritmo& conteo) {
+    int64_t desde = ahoraNs(inicio) - origenNs.load(memory_order_relaxed);
+    if (desde < 0) return;
+    if (registrados.fetch_add(1, memory_order_relaxed) >= maxEventos.load(memory_order_relaxed)) {
+        descartados.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    BuferHilo& b = buferPropio();
+    lock_guard<mutex> lock(b.m);
+    b.eventos.push_back({nombre, categoria, desde, ahoraNs(fin) - ahoraNs(inicio), conteo});
+}
+
+size_t Trazador::volcarJSON(ostream& out) {
+    lock_guard<mutex> lock(mBufers);
+    int pid = static_cast<int>(getpid());
+    size_t escritos = 0;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool primero = true;
+    for (auto& b : bufers) {
+        lock_guard<mutex> lb(b->m);
+        out << (primero ? "\n" : ",\n");
+        primero = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << b->tid
+            << ",\"args\":{\"name\":\"hilo " << b->tid << "\"}}";
+        for (const auto& e : b->eventos) {
+            out << ",\n{\"name\":\"" << e.nombre << "\",\"cat\":\"" << e.categoria
+                << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << b->tid
+                << fixed << setprecision(3)
+                << ",\"ts\":" << e.inicioNs / 1000.0 << ",\"dur\":" << e.duracionNs / 1000.0
+                << ",\"args\":{";
+            escribirConteo(out, e.conteo);
+            out << "}}";
+            escritos++;
+        }
+    }
+    out << "\n]}\n";
+    return escritos;
+}
+
+const char* categoriaOperacion(Operacion op) {
+    // Sin default: -Wswitch avisa si se agrega una operacion sin categoria
+    switch (op) {
+        case Operacion::CargarRed:
+        case Operacion::GuardarRed:
+        case Operacion::Dijkstra:
+        case Operacion::DijkstraHora:
+        case Operacion::BFS:
+        case Operacion::DFS:
+        case Operacion::Isocrona:
+        case Operacion::Componentes:
+        case Operacion::Cuellos:
+        case Operacion::ArbolCSR:
+        case Operacion::ArbolComprimido:
+        case Operacion::RutasAlternas:
+        case Operacion::Equilibrio:
+        case Operacion::Simulacion:
+        case Operacion::BuscarNombre:
+        case Operacion::ImportarRed:
+            return "red";
+        case Operacion::HashInsertar:
+        case Operacion::HashBuscar:
+        case Operacion::HashBorrar:
+        case Operacion::HashConsulta:
+            return "hash";
+        case Operacion::ServidorLote:
+            return "servidor";
+        case Operacion::NUM_OPERACIONES:
+            break;
+    }
+    return "otra";
+}
+
+double MedicionOperacion::terminar() {
+    auto fin = chrono::steady_clock::now();
+    if (!registrada) {
+        registrada = true;
+        auto ns = chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count();
+        Metricas::global().registrar(op, static_cast<uint64_t>(ns), conteo);
+        if (Trazador::global().activa()) {
+            Trazador::global().registrar(NOMBRES_OPERACION[static_cast<int>(op)], categoriaOperacion(op), inicio, fin,
+                                         conteo);
+        }
+    }
+    return chrono::duration<double>(fin - inicio).count();
+}
+
+}  // namespace trafico
@@ -0,0 +1,237 @@
+// Metricas por operacion y traza de eventos.
+#ifndef TRAFICO_METRICAS_H
+#define TRAFICO_METRICAS_H
+
+#include "comun.h"
+
+namespace trafico {
+
+// Metricas internas: llamadas por operacion, histogramas de latencia con reloj
+// de pared y contadores de los algoritmos. Todo es atomico con orden relajado,
+// asi que medir cuesta dos lecturas del reloj y unas pocas sumas por llamada.
+
+enum class Operacion {
+    CargarRed, GuardarRed, Dijkstra, DijkstraHora, BFS, DFS, Isocrona,
+    Componentes, Cuellos, ArbolCSR, ArbolComprimido, RutasAlternas, Equilibrio, Simulacion,
+    BuscarNombre, HashInsertar, HashBuscar, HashBorrar, HashConsulta, ServidorLote, ImportarRed,
+    NUM_OPERACIONES
+};
+
+const int NUM_OPERACIONES = static_cast<int>(Operacion::NUM_OPERACIONES);
+
+const char* const NOMBRES_OPERACION[NUM_OPERACIONES] = {
+    "cargar_red", "guardar_red", "dijkstra", "dijkstra_hora", "bfs", "dfs", "isocrona",
+    "componentes", "cuellos", "arbol_csr", "arbol_comprimido", "rutas_alternas", "equilibrio", "simulacion",
+    "buscar_nombre", "hash_insertar", "hash_buscar", "hash_borrar", "hash_consulta", "servidor_lote", "importar_red"
+};
+
+// Categoria de la operacion en la traza ("red", "hash", "servidor")
+const char* categoriaOperacion(Operacion op);
+
+// Contadores que acumula cada algoritmo durante una llamada
+struct ConteoAlgoritmo {
+    uint64_t asentados = 0;   // nodos extraidos definitivamente
+    uint64_t relajadas = 0;   // aristas examinadas
+    uint64_t pushes = 0;      // inserciones en el heap o la cola
+    uint64_t sondeos = 0;     // entradas comparadas en la tabla hash
+};
+
+// Histograma log-lineal al estilo HDR: cada potencia de dos se parte en 16
+// sub-buckets, lo que da un error relativo maximo de 1/16 en cualquier escala
+// (de nanosegundos a horas) con menos de mil contadores.
+class HistogramaLatencia {
+private:
+    static const int SUB_BITS = 4;
+    static const int SUB = 1 << SUB_BITS;
+    static const int NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB;
+
+    std::atomic<uint64_t> buckets[NUM_BUCKETS];
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> suma{0};
+    std::atomic<uint64_t> maximo{0};
+
+    static int indice(uint64_t v) {
+        if (v < static_cast<uint64_t>(SUB)) return static_cast<int>(v);
+        int corrimiento = 63 - __builtin_clzll(v) - SUB_BITS;
+        return (corrimiento + 1) * SUB + static_cast<int>((v >> corrimiento) - SUB);
+    }
+
+    // Mayor valor que cae en el bucket i
+    static uint64_t techo(int i) {
+        if (i < SUB) return i;
+        int corrimiento = i / SUB - 1;
+        uint64_t base = static_cast<uint64_t>(i % SUB + SUB);
+        return ((base + 1) << corrimiento) - 1;
+    }
+
+public:
+    HistogramaLatencia() { reiniciar(); }
+
+    void registrar(uint64_t ns) {
+        buckets[indice(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        suma.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t actual = maximo.load(std::memory_order_relaxed);
+        while (ns > actual && !maximo.compare_exchange_weak(actual, ns, std::memory_order_relaxed)) {}
+    }
+
+    void reiniciar() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        suma.store(0, std::memory_order_relaxed);
+        maximo.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t getTotal() const { return total.load(std::memory_order_relaxed); }
+    uint64_t getMaximo() const { return maximo.load(std::memory_order_relaxed); }
+
+    double promedio() const {
+        uint64_t n = getTotal();
+        return n ? static_cast<double>(suma.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Percentil p (0-100) en nanosegundos, acotado por el maximo observado
+    uint64_t percentil(double p) const;
+};
+
+struct MetricaOperacion {
+    HistogramaLatencia latencia;
+    std::atomic<uint64_t> asentados{0};
+    std::atomic<uint64_t> relajadas{0};
+    std::atomic<uint64_t> pushes{0};
+    std::atomic<uint64_t> sondeos{0};
+};
+
+class Metricas {
+private:
+    MetricaOperacion ops[NUM_OPERACIONES];
+
+    static std::string formatoDuracion(double ns);
+
+public:
+    static Metricas& global() {
+        static Metricas instancia;
+        return instancia;
+    }
+
+    void registrar(Operacion op, uint64_t ns, const ConteoAlgoritmo& c);
+
+    void reiniciar();
+
+    void mostrar(std::ostream& out) const;
+
+    // Volcado en JSON; latencias en nanosegundos
+    void volcarJSON(std::ostream& out) const;
+};
+
+// Traza de eventos en formato Chrome (chrome://tracing, Perfetto). Apagada
+// cuesta una lectura atomica por operacion; encendida, cada hilo acumula sus
+// eventos en un bufer propio cuyo candado solo se disputa al volcar la traza.
+struct EventoTraza {
+    const char* nombre;
+    const char* categoria;
+    int64_t inicioNs;
+    int64_t duracionNs;
+    ConteoAlgoritmo conteo;
+};
+
+class Trazador {
+private:
+    struct BuferHilo {
+        int tid = 0;
+        std::mutex m;
+        std::vector<EventoTraza> eventos;
+    };
+
+    std::atomic<bool> activo{false};
+    std::atomic<int64_t> origenNs{0};
+    std::atomic<size_t> registrados{0};
+    std::atomic<size_t> descartados{0};
+    std::atomic<int> siguienteTid{1};
+    std::atomic<size_t> maxEventos{0};
+    std::mutex mBufers;
+    std::vector<std::shared_ptr<BuferHilo>> bufers;
+
+    static int64_t ahoraNs(std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    // Los bufers sobreviven a sus hilos para no perder eventos al volcar
+    BuferHilo& buferPropio();
+
+    static void escribirConteo(std::ostream& out, const ConteoAlgoritmo& c);
+
+public:
+    static Trazador& global() {
+        static Trazador instancia;
+        return instancia;
+    }
+
+    bool activa() const { return activo.load(std::memory_order_relaxed); }
+    size_t getDescartados() const { return descartados.load(std::memory_order_relaxed); }
+
+    // Empieza una traza nueva; pasado 'limite' los eventos se descartan
+    void iniciar(size_t limite);
+
+    void detener() { activo.store(false, std::memory_order_release); }
+
+    void registrar(const char* nombre, const char* categoria, std::chrono::steady_clock::time_point inicio,
+                   std::chrono::steady_clock::time_point fin, const ConteoAlgoritmo& conteo = {});
+
+    // Escribe la traza en formato JSON de Chrome; devuelve los eventos escritos
+    size_t volcarJSON(std::ostream& out);
+};
+
+// Fase con nombre dentro de una operacion; solo lee el reloj si hay traza
+class TramoTraza {
+private:
+    const char* nombre;
+    bool activo;
+    std::chrono::steady_clock::time_point inicio;
+
+public:
+    explicit TramoTraza(const char* n) : nombre(n), activo(Trazador::global().activa()) {
+        if (activo) inicio = std::chrono::steady_clock::now();
+    }
+
+    TramoTraza(const TramoTraza&) = delete;
+    TramoTraza& operator=(const TramoTraza&) = delete;
+
+    ~TramoTraza() { cerrar(); }
+
+    // Cierra el tramo antes de salir del ambito
+    void cerrar() {
+        if (activo) Trazador::global().registrar(nombre, "fase", inicio, std::chrono::steady_clock::now());
+        activo = false;
+    }
+};
+
+// Mide una operacion con el reloj de pared. Se registra al llamar a terminar()
+// (p. ej. antes de imprimir resultados) o, si no, al salir del ambito.
+// Los algoritmos suman sus contadores en 'conteo' mientras trabajan.
+class MedicionOperacion {
+private:
+    Operacion op;
+    std::chrono::steady_clock::time_point inicio;
+    bool registrada = false;
+
+public:
+    ConteoAlgoritmo conteo;
+
+    explicit MedicionOperacion(Operacion o) : op(o), inicio(std::chrono::steady_clock::now()) {}
+
+    MedicionOperacion(const MedicionOperacion&) = delete;
+    MedicionOperacion& operator=(const MedicionOperacion&) = delete;
+
+    ~MedicionOperacion() {
+        if (!registrada) terminar();
+    }
+
+    // Devuelve los segundos transcurridos; solo la primera llamada registra
+    // (en las metricas y, si esta encendida, en la traza)
+    double terminar();
+};
+
+}  // namespace trafico
+
+#endif
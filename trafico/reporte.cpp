@@ -0,0 +1,154 @@
+#include "reporte.h"
+
+#include <charconv>
+
+using namespace std;
+
+namespace trafico {
+
+SalidaBuffer& SalidaBuffer::texto(string_view s) {
+    if (s.size() > buf.size() - usado) {
+        vaciar();
+        // Un texto mayor que el bloque va directo al flujo
+        if (s.size() >= buf.size()) {
+            out.write(s.data(), static_cast<streamsize>(s.size()));
+            escritos += s.size();
+            return *this;
+        }
+    }
+    memcpy(buf.data() + usado, s.data(), s.size());
+    usado += s.size();
+    return *this;
+}
+
+SalidaBuffer& SalidaBuffer::entero(long long v) {
+    char* p = reservar(24);
+    usado = to_chars(p, p + 24, v).ptr - buf.data();
+    return *this;
+}
+
+SalidaBuffer& SalidaBuffer::real(float v) {
+    char* p = reservar(32);
+    usado = to_chars(p, p + 32, v).ptr - buf.data();
+    return *this;
+}
+
+SalidaBuffer& SalidaBuffer::campoCSV(string_view s) {
+    if (s.find_first_of(",\"\n\r") == string_view::npos)
+        return texto(s);
+    caracter('"');
+    for (char c : s) {
+        if (c == '"') caracter('"');
+        caracter(c);
+    }
+    return caracter('"');
+}
+
+SalidaBuffer& SalidaBuffer::cadenaJSON(string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    caracter('"');
+    for (char c : s) {
+        unsigned char u = static_cast<unsigned char>(c);
+        switch (c) {
+            case '"': texto("\\\""); break;
+            case '\\': texto("\\\\"); break;
+            case '\n': texto("\\n"); break;
+            case '\r': texto("\\r"); break;
+            case '\t': texto("\\t"); break;
+            default:
+                if (u < 0x20) {
+                    texto("\\u00").caracter(hex[u >> 4]).caracter(hex[u & 0xF]);
+                } else {
+                    caracter(c);
+                }
+        }
+    }
+    return caracter('"');
+}
+
+void SalidaBuffer::vaciar() {
+    if (usado == 0) return;
+    out.write(buf.data(), static_cast<streamsize>(usado));
+    escritos += usado;
+    usado = 0;
+}
+
+ResumenReporte escribirListaAdj(SalidaBuffer& out, const Grafo& g, FormatoReporte formato,
+                                const FiltroReporte& filtro) {
+    const auto& nodos = g.getNodos();
+    ResumenReporte res;
+    if (formato == FormatoReporte::CSV) out.texto("origen_id,origen,destino_id,destino,peso\n");
+    if (formato == FormatoReporte::JSON) out.caracter('[');
+
+    for (const auto& n : nodos) {
+        if (n.nombre.empty() || !filtro.enRango(n.id)) continue;
+        if (!filtro.enPagina(res.total++)) continue;
+
+        switch (formato) {
+            case FormatoReporte::Texto:
+                out.texto(n.nombre).texto(" (").entero(n.id).texto("): ");
+                for (const auto& a : n.adj)
+                    out.texto("-> ").texto(nodos[a.to].nombre).caracter('(').real(a.w).texto(") ");
+                out.caracter('\n');
+                break;
+            case FormatoReporte::CSV:
+                for (const auto& a : n.adj) {
+                    out.entero(n.id).caracter(',').campoCSV(n.nombre).caracter(',');
+                    out.entero(a.to).caracter(',').campoCSV(nodos[a.to].nombre).caracter(',');
+                    out.real(a.w).caracter('\n');
+                }
+                break;
+            case FormatoReporte::JSON: {
+                out.texto(res.escritas ? ",\n" : "\n").texto("{\"id\":").entero(n.id);
+                out.texto(",\"nombre\":").cadenaJSON(n.nombre).texto(",\"aristas\":[");
+                bool primera = true;
+                for (const auto& a : n.adj) {
+                    out.texto(primera ? "{\"destino\":" : ",{\"destino\":").entero(a.to);
+                    out.texto(",\"peso\":").real(a.w).caracter('}');
+                    primera = false;
+                }
+                out.texto("]}");
+                break;
+            }
+        }
+        res.escritas++;
+    }
+
+    if (formato == FormatoReporte::JSON) out.texto("\n]\n");
+    return res;
+}
+
+ResumenReporte escribirRecorrido(SalidaBuffer& out, const Grafo& g, const vector<int>& orden,
+                                 FormatoReporte formato, const FiltroReporte& filtro) {
+    const auto& nodos = g.getNodos();
+    ResumenReporte res;
+    if (formato == FormatoReporte::CSV) out.texto("posicion,id,nombre\n");
+    if (formato == FormatoReporte::JSON) out.caracter('[');
+
+    for (size_t i = 0; i < orden.size(); i++) {
+        int id = orden[i];
+        if (!filtro.enRango(id)) continue;
+        if (!filtro.enPagina(res.total++)) continue;
+        string_view nombre = id >= 0 && id < static_cast<int>(nodos.size()) ? nodos[id].nombre : string_view();
+
+        switch (formato) {
+            case FormatoReporte::Texto:
+                out.texto(nombre).caracter(' ');
+                break;
+            case FormatoReporte::CSV:
+                out.entero(static_cast<long long>(i)).caracter(',').entero(id).caracter(',');
+                out.campoCSV(nombre).caracter('\n');
+                break;
+            case FormatoReporte::JSON:
+                out.texto(res.escritas ? ",\n" : "\n").texto("{\"posicion\":").entero(static_cast<long long>(i));
+                out.texto(",\"id\":").entero(id).texto(",\"nombre\":").cadenaJSON(nombre).caracter('}');
+                break;
+        }
+        res.escritas++;
+    }
+
+    if (formato == FormatoReporte::JSON) out.texto("\n]\n");
+    return res;
+}
+
+}  // namespace trafico
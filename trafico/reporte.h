@@ -0,0 +1,89 @@
+// Salida de reportes grandes (adyacencia, recorridos) en texto, CSV o JSON.
+#ifndef TRAFICO_REPORTE_H
+#define TRAFICO_REPORTE_H
+
+#include <ostream>
+
+#include "grafo.h"
+
+namespace trafico {
+
+// Acumula la salida en un bloque fijo y lo escribe al flujo de una vez cuando
+// se llena o al destruirse; nunca vacia el flujo por linea. Los numeros se
+// formatean con to_chars, sin pasar por el estado (precision, fixed) del flujo.
+class SalidaBuffer {
+public:
+    static constexpr size_t TAM_BLOQUE = 1 << 16;
+
+    explicit SalidaBuffer(std::ostream& destino) : out(destino), buf(TAM_BLOQUE), usado(0), escritos(0) {}
+    ~SalidaBuffer() { vaciar(); }
+
+    SalidaBuffer(const SalidaBuffer&) = delete;
+    SalidaBuffer& operator=(const SalidaBuffer&) = delete;
+
+    SalidaBuffer& texto(std::string_view s);
+    SalidaBuffer& caracter(char c) {
+        if (usado == buf.size()) vaciar();
+        buf[usado++] = c;
+        return *this;
+    }
+    SalidaBuffer& entero(long long v);
+    // Representacion mas corta que se lee de vuelta como el mismo float
+    SalidaBuffer& real(float v);
+    // Entre comillas si hace falta, duplicando las comillas internas
+    SalidaBuffer& campoCSV(std::string_view s);
+    // Entre comillas y con los caracteres de control escapados
+    SalidaBuffer& cadenaJSON(std::string_view s);
+
+    // Escribe el bloque pendiente al flujo (sin hacer flush del flujo)
+    void vaciar();
+
+    size_t bytesEscritos() const { return escritos + usado; }
+
+private:
+    std::ostream& out;
+    std::vector<char> buf;
+    size_t usado;
+    size_t escritos;
+
+    // Garantiza n bytes libres y devuelve donde escribirlos
+    char* reservar(size_t n) {
+        if (buf.size() - usado < n) vaciar();
+        return buf.data() + usado;
+    }
+};
+
+enum class FormatoReporte { Texto, CSV, JSON };
+
+// Nodos a incluir: IDs en [desde, hasta] y, si porPagina > 0, solo la pagina
+// indicada (desde 0) de las filas que pasan el rango
+struct FiltroReporte {
+    int desde = 0;
+    int hasta = std::numeric_limits<int>::max();
+    size_t pagina = 0;
+    size_t porPagina = 0;
+
+    bool enRango(int id) const { return id >= desde && id <= hasta; }
+    bool enPagina(size_t fila) const { return porPagina == 0 || fila / porPagina == pagina; }
+};
+
+struct ResumenReporte {
+    size_t escritas = 0;    // filas de la pagina escrita
+    size_t total = 0;       // filas que pasan el filtro de rango
+};
+
+// Una fila por nodo (en CSV, una por arista): texto "Nombre (id): -> Destino(w) ...",
+// CSV "origen_id,origen,destino_id,destino,peso", JSON un arreglo de
+// {"id","nombre","aristas":[{"destino","peso"}]}
+ResumenReporte escribirListaAdj(SalidaBuffer& out, const Grafo& g, FormatoReporte formato,
+                                const FiltroReporte& filtro = {});
+
+// Una fila por nodo visitado, en el orden de 'orden': texto con los nombres
+// separados por espacios, CSV "posicion,id,nombre", JSON un arreglo de
+// {"posicion","id","nombre"}
+ResumenReporte escribirRecorrido(SalidaBuffer& out, const Grafo& g, const std::vector<int>& orden,
+                                 FormatoReporte formato, const FiltroReporte& filtro = {});
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,233 @@
+#include "servidor.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace trafico {
+
+ServidorConsultas::Conexion::~Conexion() { close(fd); }
+
+void ServidorConsultas::Conexion::responder(long seq, string texto) {
+    lock_guard<mutex> lock(mtx);
+    pendientes[seq] = move(texto);
+    while (!pendientes.empty() && pendientes.begin()->first == siguiente) {
+        const string& s = pendientes.begin()->second;
+        size_t enviado = 0;
+        while (!rota && enviado < s.size()) {
+            ssize_t n = send(fd, s.data() + enviado, s.size() - enviado, MSG_NOSIGNAL);
+            if (n <= 0) rota = true;
+            else enviado += n;
+        }
+        pendientes.erase(pendientes.begin());
+        siguiente++;
+    }
+}
+
+string ServidorConsultas::nombresCamino(const VersionGrafo& v, const vector<int>& camino) {
+    string out;
+    for (int id : camino) {
+        out += ' ';
+        out += v.nodo(id).nombre;
+    }
+    return out;
+}
+
+void ServidorConsultas::atenderLote(vector<Solicitud>& lote) {
+    TramoTraza tramo("servidor.lote");
+    MedicionOperacion med(Operacion::ServidorLote);
+    auto version = red.fijar();
+    vector<string> respuestas(lote.size());
+    map<int, vector<pair<size_t, int>>> porOrigen;  // origen -> (solicitud, destino)
+
+    for (size_t i = 0; i < lote.size(); ++i) {
+        istringstream in(lote[i].linea);
+        string cmd, a, b;
+        in >> cmd;
+        if (cmd == "RUTA") {
+            if (!(in >> a >> b)) {
+                respuestas[i] = "ERR uso: RUTA <origen> <destino>";
+                continue;
+            }
+            int s = version->getIdByName(a);
+            int e = version->getIdByName(b);
+            if (s == -1 || e == -1) respuestas[i] = "ERR nodo inexistente";
+            else porOrigen[s].push_back({i, e});
+        } else if (cmd == "BFS" || cmd == "DFS") {
+            int s = (in >> a) ? version->getIdByName(a) : -1;
+            if (s == -1) {
+                respuestas[i] = "ERR nodo inexistente";
+                continue;
+            }
+            vector<int> orden = version->recorrido(s, cmd == "BFS");
+            respuestas[i] = "OK " + to_string(orden.size()) + nombresCamino(*version, orden);
+        } else if (cmd == "VEH") {
+            Vehiculo v;
+            if ((in >> a) && vehiculos.search(a, v)) respuestas[i] = "OK " + registroVehiculo(v);
+            else respuestas[i] = "ERR vehiculo no encontrado";
+        } else if (cmd == "PING") {
+            respuestas[i] = "OK";
+        } else if (cmd == "APAGAR") {
+            respuestas[i] = "OK apagando";
+            detener = true;
+            hayTrabajo.notify_all();
+        } else {
+            respuestas[i] = "ERR comando desconocido: " + cmd;
+        }
+    }
+
+    for (const auto& [s, pedidos] : porOrigen) {
+        vector<int> destinos;
+        for (const auto& p : pedidos) destinos.push_back(p.second);
+        vector<Ruta> encontradas = version->rutasDesde(s, destinos);
+        for (size_t k = 0; k < pedidos.size(); ++k) {
+            const Ruta& r = encontradas[k];
+            if (r.camino.empty()) {
+                respuestas[pedidos[k].first] = "ERR sin camino";
+                continue;
+            }
+            ostringstream out;
+            out << "OK " << fixed << setprecision(2) << r.distancia << nombresCamino(*version, r.camino);
+            respuestas[pedidos[k].first] = out.str();
+        }
+        rutas += static_cast<long>(pedidos.size());
+        arboles++;
+    }
+
+    for (size_t i = 0; i < lote.size(); ++i) {
+        lote[i].con->responder(lote[i].seq, respuestas[i] + "\n");
+    }
+    solicitudes += static_cast<long>(lote.size());
+    lotes++;
+}
+
+void ServidorConsultas::trabajar() {
+    vector<Solicitud> lote;
+    while (true) {
+        {
+            unique_lock<mutex> lock(mtxCola);
+            hayTrabajo.wait(lock, [this]() { return !cola.empty() || detener.load(); });
+            if (cola.empty()) return;
+            size_t n = min(cola.size(), static_cast<size_t>(TAM_LOTE));
+            lote.assign(make_move_iterator(cola.begin()), make_move_iterator(cola.begin() + n));
+            cola.erase(cola.begin(), cola.begin() + n);
+        }
+        atenderLote(lote);
+        lote.clear();
+    }
+}
+
+ServidorConsultas::~ServidorConsultas() {
+    if (srv >= 0) {
+        close(srv);
+        unlink(rutaSocket.c_str());
+    }
+}
+
+bool ServidorConsultas::abrir(const string& ruta) {
+    sockaddr_un dir{};
+    dir.sun_family = AF_UNIX;
+    if (ruta.empty() || ruta.size() >= sizeof(dir.sun_path)) {
+        error = "Ruta de socket invalida.";
+        return false;
+    }
+    strcpy(dir.sun_path, ruta.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = "No se pudo crear el socket.";
+        return false;
+    }
+    unlink(ruta.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0 || listen(fd, 64) < 0) {
+        error = "No se pudo escuchar en " + ruta;
+        close(fd);
+        return false;
+    }
+    srv = fd;
+    rutaSocket = ruta;
+    return true;
+}
+
+EstadisticasServidor ServidorConsultas::atender(int hilos, int fdParada) {
+    EstadisticasServidor est;
+    if (srv < 0) return est;
+    detener = false;
+    auto inicio = chrono::steady_clock::now();
+    vector<thread> trabajadores;
+    for (int t = 0; t < hilos; ++t) trabajadores.emplace_back(&ServidorConsultas::trabajar, this);
+
+    struct Lector {
+        shared_ptr<Conexion> con;
+        string buffer;
+        long seq = 0;
+    };
+    vector<Lector> lectores;
+    vector<pollfd> fds;
+    char buf[4096];
+
+    while (!detener) {
+        fds.assign({{srv, POLLIN, 0}, {fdParada, POLLIN, 0}});
+        for (const auto& l : lectores) fds.push_back({l.con->fd, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), 200) <= 0) continue;
+
+        if (fds[1].revents & (POLLIN | POLLHUP)) {
+            est.paradaExterna = true;
+            break;
+        }
+        // Se recorre de atras hacia adelante para poder quitar lectores
+        for (size_t k = lectores.size(); k-- > 0;) {
+            short ev = fds[k + 2].revents;
+            if (!ev) continue;
+            Lector& l = lectores[k];
+            ssize_t n = (ev & (POLLIN | POLLHUP | POLLERR)) ? read(l.con->fd, buf, sizeof(buf)) : 1;
+            bool cerrar = n <= 0;
+            if (n > 0 && (ev & POLLIN)) l.buffer.append(buf, n);
+            size_t pos, ini = 0;
+            while (!cerrar && (pos = l.buffer.find('\n', ini)) != string::npos) {
+                string linea = l.buffer.substr(ini, pos - ini);
+                ini = pos + 1;
+                if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+                if (linea.empty()) continue;
+                if (linea == "SALIR") cerrar = true;
+                else encolar(l.con, l.seq++, move(linea));
+            }
+            l.buffer.erase(0, ini);
+            if (l.buffer.size() > MAX_LINEA) {
+                l.con->responder(l.seq++, "ERR linea demasiado larga\n");
+                cerrar = true;
+            }
+            // Las respuestas pendientes conservan la conexion hasta enviarse
+            if (cerrar) lectores.erase(lectores.begin() + k);
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(srv, nullptr, nullptr);
+            if (fd >= 0) {
+                // Un cliente que no lee no debe bloquear para siempre a un trabajador
+                timeval espera{5, 0};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &espera, sizeof(espera));
+                lectores.push_back({make_shared<Conexion>(fd), "", 0});
+                est.clientes++;
+            }
+        }
+    }
+
+    parar();
+    for (auto& t : trabajadores) t.join();
+    cola.clear();
+    lectores.clear();
+    close(srv);
+    unlink(rutaSocket.c_str());
+    srv = -1;
+
+    est.solicitudes = solicitudes;
+    est.lotes = lotes;
+    est.rutas = rutas;
+    est.arboles = arboles;
+    est.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return est;
+}
+
+}  // namespace trafico
@@ -0,0 +1,113 @@
+// Servidor local de consultas sobre un socket Unix.
+#ifndef TRAFICO_SERVIDOR_H
+#define TRAFICO_SERVIDOR_H
+
+#include "versionado.h"
+#include "vehiculos.h"
+
+namespace trafico {
+
+// Resultado de una sesion del servidor de consultas
+struct EstadisticasServidor {
+    int clientes = 0;
+    long solicitudes = 0;
+    long lotes = 0;
+    long rutas = 0;
+    long arboles = 0;
+    double segundos = 0;
+    bool paradaExterna = false;     // se detuvo por datos en fdParada
+};
+
+// Servidor local de consultas sobre un socket Unix. La red y los vehiculos se
+// cargan una vez y se atienden varios clientes con un protocolo de lineas:
+//   RUTA <origen> <destino>  -> OK <distancia> <nodo> <nodo> ...
+//   BFS <origen>, DFS <origen> -> OK <alcanzados> <nodo> <nodo> ...
+//   VEH <id>                 -> OK V;id;tipo;placa;origen;destino;hora
+//   PING -> OK; SALIR cierra la conexion; APAGAR detiene el servidor
+// Los errores se responden con "ERR <motivo>". El hilo principal lee los
+// sockets y encola las lineas; los trabajadores toman lotes de la cola y
+// resuelven con un solo Dijkstra las rutas del lote que comparten origen.
+// Cada conexion recibe las respuestas en el orden de sus solicitudes.
+class ServidorConsultas {
+private:
+    static const int TAM_LOTE = 64;
+    static const size_t MAX_LINEA = 4096;
+
+    struct Conexion {
+        int fd;
+        std::mutex mtx;
+        long siguiente = 0;             // numero de la proxima respuesta a enviar
+        std::map<long, std::string> pendientes;   // respuestas listas que llegaron antes de tiempo
+        bool rota = false;
+
+        explicit Conexion(int f) : fd(f) {}
+        ~Conexion();
+
+        void responder(long seq, std::string texto);
+    };
+
+    struct Solicitud {
+        std::shared_ptr<Conexion> con;
+        long seq;
+        std::string linea;
+    };
+
+    GrafoVersionado red;
+    HashTableConcurrente vehiculos;
+
+    std::mutex mtxCola;
+    std::condition_variable hayTrabajo;
+    std::deque<Solicitud> cola;
+    std::atomic<bool> detener{false};
+
+    std::atomic<long> solicitudes{0}, lotes{0}, rutas{0}, arboles{0};
+    int srv = -1;
+    std::string rutaSocket;
+
+    static std::string nombresCamino(const VersionGrafo& v, const std::vector<int>& camino);
+
+    void atenderLote(std::vector<Solicitud>& lote);
+
+    // Los trabajadores vacian la cola antes de salir, asi que toda solicitud
+    // encolada antes de APAGAR recibe respuesta
+    void trabajar();
+
+    void encolar(const std::shared_ptr<Conexion>& con, long seq, std::string linea) {
+        {
+            std::lock_guard<std::mutex> lock(mtxCola);
+            cola.push_back({con, seq, std::move(linea)});
+        }
+        hayTrabajo.notify_one();
+    }
+
+public:
+    std::string error;
+
+    ServidorConsultas(const Grafo& g, const HashTable& ht)
+        : vehiculos(64, ht.estadisticas().vehiculos) {
+        red.reconstruir(g);
+        for (const Vehiculo& v : ht.todos()) vehiculos.insert(v.id, v);
+    }
+
+    ~ServidorConsultas();
+
+    ServidorConsultas(const ServidorConsultas&) = delete;
+    ServidorConsultas& operator=(const ServidorConsultas&) = delete;
+
+    // Crea el socket y empieza a escuchar; si falla deja el motivo en 'error'
+    bool abrir(const std::string& ruta);
+
+    // Pide a atender() que termine; se puede llamar desde otro hilo
+    void parar() {
+        detener = true;
+        hayTrabajo.notify_all();
+    }
+
+    // Atiende hasta recibir APAGAR, parar() o datos en 'fdParada' (que no se
+    // leen: quedan para quien llama). Al salir cierra y borra el socket.
+    EstadisticasServidor atender(int hilos, int fdParada = -1);
+};
+
+}  // namespace trafico
+
+#endif
@@ -0,0 +1,469 @@
+#include "simulacion.h"
+
+using namespace std;
+
+namespace trafico {
+
+void SimuladorTrafico::arbolHaciaDestino(const GrafoCSR& inversa, int d, vector<float>& dist, int* siguiente) {
+    const float INF = numeric_limits<float>::infinity();
+    fill(dist.begin(), dist.end(), INF);
+    fill(siguiente, siguiente + inversa.numNodos, -1);
+    KernelRelajacion relajar = kernelRelajacion().load(memory_order_relaxed);
+    vector<int> candidatos;
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    dist[d] = 0;
+    pq.push({0, d});
+    while (!pq.empty()) {
+        float du = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (du > dist[u]) continue;
+
+        auto aplicar = [&](int k) {
+            int v = inversa.destino[k];
+            float nd = du + inversa.peso[k];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                siguiente[v] = inversa.aristaOriginal[k];
+                pq.push({nd, v});
+            }
+        };
+        int k0 = inversa.inicio[u];
+        int grado = inversa.inicio[u + 1] - k0;
+        if (grado >= GRADO_MINIMO_SIMD) {
+            if (static_cast<int>(candidatos.size()) < grado) candidatos.resize(grado);
+            int m = relajar(du, &inversa.destino[k0], &inversa.peso[k0], grado, dist.data(), candidatos.data());
+            for (int c = 0; c < m; ++c) aplicar(k0 + candidatos[c]);
+        } else {
+            for (int k = k0; k < k0 + grado; ++k) aplicar(k);
+        }
+    }
+}
+
+ResultadoSimulacion SimuladorTrafico::simular(const vector<Vehiculo>& vehiculos, int hilos) {
+    MedicionOperacion med(Operacion::Simulacion);
+    ResultadoSimulacion res;
+    res.vehiculos = static_cast<int>(vehiculos.size());
+    res.ocupacionMaxima.assign(red.numAristas(), 0);
+    res.pasadas.assign(red.numAristas(), 0);
+    int n = red.numNodos;
+
+    // 1) Rutas: un arbol por destino distinto (en paralelo). Cada hilo reusa
+    // una sola tabla de siguiente arista de n enteros y de cada arbol extrae
+    // solo los caminos de los vehiculos que van a ese destino (uno por origen
+    // distinto), asi la memoria crece con las rutas y no con destinos x nodos.
+    auto t0 = chrono::steady_clock::now();
+    TramoTraza tramoRutas("simulacion.rutas");
+    int numV = res.vehiculos;
+    unordered_map<int, int> idxDestino;
+    vector<int> destinos;
+    vector<vector<int>> vehiculosPorDestino;
+    vector<int> tabla(numV, -1);
+    for (int v = 0; v < numV; ++v) {
+        if (!red.existe(vehiculos[v].destino)) continue;
+        auto [it, nuevo] = idxDestino.emplace(vehiculos[v].destino, static_cast<int>(destinos.size()));
+        if (nuevo) {
+            destinos.push_back(vehiculos[v].destino);
+            vehiculosPorDestino.emplace_back();
+        }
+        vehiculosPorDestino[it->second].push_back(v);
+        tabla[v] = it->second;
+    }
+    res.destinosDistintos = static_cast<int>(destinos.size());
+    // El camino del vehiculo v son las aristas rutas[tabla[v]] desde inicioRuta[v]
+    // hasta llegar al destino; -1 si no hay camino
+    vector<vector<int>> rutas(destinos.size());
+    vector<int> inicioRuta(numV, -1);
+    GrafoCSR inversa = red.transpuesto();
+    atomic<int> proximo(0);
+    vector<thread> workers;
+    for (int t = 0; t < max(hilos, 1); ++t) {
+        workers.emplace_back([&]() {
+            TramoTraza tramo("simulacion.rutas_hilo");
+            vector<float> dist(n);
+            vector<int> siguiente(n);
+            unordered_map<int, int> inicioPorOrigen;
+            for (int i = proximo++; i < static_cast<int>(destinos.size()); i = proximo++) {
+                int d = destinos[i];
+                arbolHaciaDestino(inversa, d, dist, siguiente.data());
+                inicioPorOrigen.clear();
+                vector<int>& ruta = rutas[i];
+                for (int v : vehiculosPorDestino[i]) {
+                    int u = vehiculos[v].origen;
+                    if (!red.existe(u) || (u != d && siguiente[u] == -1)) continue;
+                    auto [it, nuevo] = inicioPorOrigen.emplace(u, static_cast<int>(ruta.size()));
+                    if (nuevo) {
+                        for (; u != d; u = red.destino[siguiente[u]]) ruta.push_back(siguiente[u]);
+                    }
+                    inicioRuta[v] = it->second;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    res.segundosRutas = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    tramoRutas.cerrar();
+
+    // 2) Estado por vehiculo y liberacion a su hora de entrada
+    auto t1 = chrono::steady_clock::now();
+    TramoTraza tramoEventos("simulacion.eventos");
+    vector<int> nodoActual(numV), aristaActual(numV, -1), paso(numV), salida(numV);
+    vector<int> tiempoEvento(numV);
+    vector<vector<int>> rueda(TAM_RUEDA);
+    long pendientes = 0;
+    int tiempoMin = numeric_limits<int>::max();
+
+    auto programar = [&](int v, int t) {
+        tiempoEvento[v] = t;
+        rueda[t & (TAM_RUEDA - 1)].push_back(v);
+        pendientes++;
+    };
+
+    for (int v = 0; v < numV; ++v) {
+        const Vehiculo& veh = vehiculos[v];
+        int minuto = horaAMinutos(veh.horaEntrada);
+        if (minuto < 0 || inicioRuta[v] < 0) {
+            res.sinRuta++;
+            continue;
+        }
+        nodoActual[v] = veh.origen;
+        paso[v] = inicioRuta[v];
+        salida[v] = minuto * 60;
+        programar(v, salida[v]);
+        tiempoMin = min(tiempoMin, salida[v]);
+    }
+
+    // 3) Avance de la rueda: en cada ranura se procesan los vehiculos cuyo
+    // evento cae en ese segundo; los de vueltas posteriores se conservan
+    long sumaViaje = 0;
+    vector<int> ocupacion(red.numAristas(), 0);
+    vector<int> actuales, quedan;
+    for (int t = (pendientes ? tiempoMin : 0); pendientes > 0; ++t) {
+        vector<int>& ranura = rueda[t & (TAM_RUEDA - 1)];
+        if (ranura.empty()) continue;
+        quedan.clear();
+        actuales.clear();
+        actuales.swap(ranura);
+        for (int v : actuales) {
+            if (tiempoEvento[v] != t) {
+                quedan.push_back(v);
+                continue;
+            }
+            pendientes--;
+            res.eventos++;
+            if (aristaActual[v] != -1) {
+                // Sale de la arista que recorria
+                int e = aristaActual[v];
+                nodoActual[v] = red.destino[e];
+                aristaActual[v] = -1;
+                ocupacion[e]--;
+            }
+            int u = nodoActual[v];
+            if (u == vehiculos[v].destino) {
+                res.completados++;
+                sumaViaje += t - salida[v];
+                res.ultimaLlegada = max(res.ultimaLlegada, t);
+                continue;
+            }
+            int e = rutas[tabla[v]][paso[v]++];
+            aristaActual[v] = e;
+            res.pasadas[e]++;
+            res.ocupacionMaxima[e] = max(res.ocupacionMaxima[e], ++ocupacion[e]);
+            programar(v, t + duracionSeg(red.peso[e]));
+        }
+        for (int v : quedan) ranura.push_back(v);
+    }
+    res.segundosSimulacion = chrono::duration<double>(chrono::steady_clock::now() - t1).count();
+    if (res.completados) res.viajeMedioMin = sumaViaje / 60.0 / res.completados;
+    return res;
+}
+
+void generarRejilla(Grafo& g, int lado, unsigned semilla) {
+    mt19937 rng(semilla);
+    uniform_real_distribution<float> peso(1.0f, 10.0f);
+    for (int i = 0; i < lado * lado; ++i) {
+        g.altaNodo(i, "R" + to_string(i / lado) + "_" + to_string(i % lado));
+        g.fijarCoordenadas(i, static_cast<float>(i % lado), static_cast<float>(i / lado));
+    }
+    for (int f = 0; f < lado; ++f) {
+        for (int c = 0; c < lado; ++c) {
+            int u = f * lado + c;
+            if (c + 1 < lado) {
+                g.altaArista(u, u + 1, peso(rng));
+                g.altaArista(u + 1, u, peso(rng));
+            }
+            if (f + 1 < lado) {
+                g.altaArista(u, u + lado, peso(rng));
+                g.altaArista(u + lado, u, peso(rng));
+            }
+        }
+    }
+}
+
+double AsignacionEquilibrio::todoONada(const vector<float>& costo, vector<double>& flujo) const {
+    int m = red.numAristas();
+    vector<vector<double>> parciales(hilos, vector<double>(m, 0.0));
+    vector<double> costoParcial(hilos, 0.0);
+    atomic<int> proximo(0);
+    vector<thread> workers;
+    for (int t = 0; t < hilos; ++t) {
+        workers.emplace_back([&, t]() {
+            vector<float> dist;
+            vector<int> pred;
+            vector<double>& propio = parciales[t];
+            for (int i = proximo++; i < static_cast<int>(demanda.size()); i = proximo++) {
+                red.arbolDesde(demanda[i].first, costo.data(), dist, pred);
+                for (const auto& par : demanda[i].second) {
+                    int d = par.first;
+                    if (dist[d] == numeric_limits<float>::infinity()) continue;
+                    costoParcial[t] += static_cast<double>(par.second) * dist[d];
+                    for (int v = d; pred[v] != -1; v = red.origenDe(pred[v])) {
+                        propio[pred[v]] += par.second;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    flujo.assign(m, 0.0);
+    double total = 0;
+    for (int t = 0; t < hilos; ++t) {
+        total += costoParcial[t];
+        for (int k = 0; k < m; ++k) flujo[k] += parciales[t][k];
+    }
+    return total;
+}
+
+int AsignacionEquilibrio::fijarCapacidad(int from, int to, float cap) {
+    int u = red.interno(from), v = red.interno(to);
+    if (!red.existe(u) || !red.existe(v) || !isfinite(cap) || cap <= 0) return 0;
+    int cambiadas = 0;
+    for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+        if (red.destino[k] != v) continue;
+        capacidad[k] = max(cap, 1e-3f);
+        cambiadas++;
+    }
+    return cambiadas;
+}
+
+bool AsignacionEquilibrio::cargarCapacidades(const string& filename, int& ignoradas) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+    string line;
+    while (getline(file, line)) {
+        line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (line.empty() || line[0] == '#') continue;
+        stringstream ss(line);
+        string from, to, cap;
+        bool valida = false;
+        if (getline(ss, from, ';') && getline(ss, to, ';') && getline(ss, cap, ';')) {
+            try {
+                valida = fijarCapacidad(stoi(from), stoi(to), stof(cap)) > 0;
+            } catch (const exception&) {
+            }
+        }
+        if (!valida) ignoradas++;
+    }
+    return true;
+}
+
+void AsignacionEquilibrio::cargarDemanda(const vector<Vehiculo>& vehiculos) {
+    map<int, map<int, int>> od;
+    for (const auto& v : vehiculos) {
+        if (red.existe(v.origen) && red.existe(v.destino) && v.origen != v.destino) od[v.origen][v.destino]++;
+    }
+    demanda.clear();
+    for (auto& o : od) demanda.push_back({o.first, vector<pair<int, int>>(o.second.begin(), o.second.end())});
+}
+
+void AsignacionEquilibrio::resolver(int maxIter, double gapObjetivo) {
+    MedicionOperacion med(Operacion::Equilibrio);
+    int m = red.numAristas();
+    vector<float> costo(red.peso);
+    vector<double> auxiliar;
+    historial.clear();
+    todoONada(costo, flujo);
+
+    for (int it = 1; it <= maxIter; ++it) {
+        double tiempoTotal = 0;
+        for (int k = 0; k < m; ++k) {
+            costo[k] = tiempoBPR(k, flujo[k]);
+            tiempoTotal += flujo[k] * costo[k];
+        }
+        double minimo = todoONada(costo, auxiliar);
+        double gap = tiempoTotal > 0 ? (tiempoTotal - minimo) / tiempoTotal : 0;
+
+        // Paso optimo: raiz de sum (y - x) * t(x + paso * (y - x)) en [0, 1]
+        double lo = 0, hi = 1;
+        for (int b = 0; b < 30; ++b) {
+            double mid = (lo + hi) / 2;
+            double deriv = 0;
+            for (int k = 0; k < m; ++k) {
+                double dx = auxiliar[k] - flujo[k];
+                if (dx != 0) deriv += dx * tiempoBPR(k, flujo[k] + mid * dx);
+            }
+            if (deriv > 0) hi = mid; else lo = mid;
+        }
+        double paso = (lo + hi) / 2;
+        historial.push_back({it, gap, paso, tiempoTotal});
+        if (gap < gapObjetivo) break;
+        for (int k = 0; k < m; ++k) flujo[k] += paso * (auxiliar[k] - flujo[k]);
+    }
+}
+
+void RutasAlternativas::heuristicaHacia(int t) {
+    const float INF = numeric_limits<float>::infinity();
+    h.assign(red.numNodos, INF);
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    h[t] = 0;
+    pq.push({0, t});
+    while (!pq.empty()) {
+        auto [du, u] = pq.top();
+        pq.pop();
+        if (du > h[u]) continue;
+        for (int k = inversa.inicio[u]; k < inversa.inicio[u + 1]; ++k) {
+            int v = inversa.destino[k];
+            if (du + inversa.peso[k] < h[v]) {
+                h[v] = du + inversa.peso[k];
+                pq.push({h[v], v});
+            }
+        }
+    }
+}
+
+bool RutasAlternativas::desvio(int s, int t, const vector<int>& prohibidos, Camino& res) {
+    const float INF = numeric_limits<float>::infinity();
+    if (h[s] == INF) return false;
+    int m = ++marcaActual;
+    auto distDe = [&](int v) { return marca[v] == m ? dist[v] : INF; };
+
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    marca[s] = m;
+    dist[s] = 0;
+    predArista[s] = -1;
+    pq.push({h[s], s});
+    while (!pq.empty()) {
+        auto [f, u] = pq.top();
+        pq.pop();
+        if (f > dist[u] + h[u]) continue;
+        if (u == t) break;
+        for (int k = red.inicio[u]; k < red.inicio[u + 1]; ++k) {
+            int v = red.destino[k];
+            if (bloqueado[v] == marcaBloqueo || h[v] == INF) continue;
+            if (u == s && find(prohibidos.begin(), prohibidos.end(), v) != prohibidos.end()) continue;
+            float nd = dist[u] + red.peso[k];
+            if (nd < distDe(v)) {
+                marca[v] = m;
+                dist[v] = nd;
+                predArista[v] = k;
+                pq.push({nd + h[v], v});
+            }
+        }
+    }
+    if (distDe(t) == INF) return false;
+
+    res.costo = dist[t];
+    res.aristas.clear();
+    for (int v = t; v != s; v = red.origenDe(predArista[v])) res.aristas.push_back(predArista[v]);
+    reverse(res.aristas.begin(), res.aristas.end());
+    completarNodos(s, res);
+    return true;
+}
+
+vector<Ruta> RutasAlternativas::yen(int s, int t, int k) {
+    MedicionOperacion med(Operacion::RutasAlternas);
+    vector<Ruta> res;
+    if (!red.existe(s) || !red.existe(t) || k <= 0) return res;
+    heuristicaHacia(t);
+
+    vector<Camino> A;
+    Camino primero;
+    marcaBloqueo++;
+    if (!desvio(s, t, {}, primero)) return res;
+    A.push_back(primero);
+
+    auto cmp = [](const Camino& a, const Camino& b) { return a.costo > b.costo; };
+    priority_queue<Camino, vector<Camino>, decltype(cmp)> B(cmp);
+    set<vector<int>> vistos{primero.nodos};
+
+    while (static_cast<int>(A.size()) < k) {
+        const Camino prev = A.back();
+        float costoRaiz = 0;
+        for (size_t i = 0; i + 1 < prev.nodos.size(); ++i) {
+            int spur = prev.nodos[i];
+
+            // Salidas de 'spur' ya usadas por rutas con la misma raiz
+            vector<int> prohibidos;
+            for (const auto& p : A) {
+                if (p.nodos.size() > i + 1 && equal(prev.nodos.begin(), prev.nodos.begin() + i + 1, p.nodos.begin())) {
+                    prohibidos.push_back(p.nodos[i + 1]);
+                }
+            }
+            marcaBloqueo++;
+            for (size_t j = 0; j < i; ++j) bloqueado[prev.nodos[j]] = marcaBloqueo;
+
+            Camino tramo;
+            if (desvio(spur, t, prohibidos, tramo)) {
+                Camino total;
+                total.costo = costoRaiz + tramo.costo;
+                total.aristas.assign(prev.aristas.begin(), prev.aristas.begin() + i);
+                total.aristas.insert(total.aristas.end(), tramo.aristas.begin(), tramo.aristas.end());
+                completarNodos(s, total);
+                if (vistos.insert(total.nodos).second) B.push(move(total));
+            }
+            costoRaiz += red.peso[prev.aristas[i]];
+        }
+        if (B.empty()) break;
+        A.push_back(B.top());
+        B.pop();
+    }
+
+    for (const auto& c : A) res.push_back(aRuta(c));
+    return res;
+}
+
+vector<Ruta> RutasAlternativas::penalizacion(int s, int t, int k, float factor, float maxSolape, float maxEstiramiento) {
+    MedicionOperacion med(Operacion::RutasAlternas);
+    vector<Ruta> res;
+    if (!red.existe(s) || !red.existe(t) || k <= 0) return res;
+
+    vector<float> costo(red.peso);
+    vector<float> distTmp;
+    vector<int> pred;
+    vector<Camino> aceptados;
+
+    for (int intento = 0; intento < 4 * k && static_cast<int>(aceptados.size()) < k; ++intento) {
+        red.arbolDesde(s, costo.data(), distTmp, pred, t);
+        if (distTmp[t] == numeric_limits<float>::infinity()) break;
+
+        Camino c;
+        c.costo = 0;
+        for (int v = t; v != s; v = red.origenDe(pred[v])) {
+            c.aristas.push_back(pred[v]);
+            c.costo += red.peso[pred[v]];
+        }
+        reverse(c.aristas.begin(), c.aristas.end());
+        completarNodos(s, c);
+        for (int e : c.aristas) costo[e] *= (1.0f + factor);
+
+        if (!aceptados.empty() && c.costo > maxEstiramiento * aceptados[0].costo) break;
+        bool valida = true;
+        for (const auto& a : aceptados) {
+            float compartido = 0;
+            unordered_set<int> aristasA(a.aristas.begin(), a.aristas.end());
+            for (int e : c.aristas) if (aristasA.count(e)) compartido += red.peso[e];
+            if (c.costo > 0 ? compartido / c.costo > maxSolape : a.nodos == c.nodos) {
+                valida = false;
+                break;
+            }
+        }
+        if (valida) aceptados.push_back(move(c));
+    }
+
+    sort(aceptados.begin(), aceptados.end(), [](const Camino& a, const Camino& b) { return a.costo < b.costo; });
+    for (const auto& c : aceptados) res.push_back(aRuta(c));
+    return res;
+}
+
+}  // namespace trafico
@@ -0,0 +1,160 @@
+// Simulacion de trafico, asignacion en equilibrio y rutas alternativas.
+#ifndef TRAFICO_SIMULACION_H
+#define TRAFICO_SIMULACION_H
+
+#include "vehiculos.h"
+
+namespace trafico {
+
+struct ResultadoSimulacion {
+    int vehiculos = 0;
+    int completados = 0;
+    int sinRuta = 0;
+    long eventos = 0;
+    double viajeMedioMin = 0;
+    int ultimaLlegada = 0;       // segundos desde las 00:00 del primer dia
+    int destinosDistintos = 0;
+    double segundosRutas = 0;
+    double segundosSimulacion = 0;
+    std::vector<int> ocupacionMaxima;  // por arista (indice CSR)
+    std::vector<int> pasadas;          // vehiculos que recorrieron cada arista
+};
+
+// Simulacion de eventos discretos: cada vehiculo se libera a su hora de
+// entrada y avanza arista por arista por su ruta mas corta. El peso de una
+// arista se interpreta como minutos de recorrido. Los eventos se guardan en
+// una rueda de tiempo (timing wheel) con ranuras de un segundo.
+class SimuladorTrafico {
+private:
+    static const int TAM_RUEDA = 1 << 12;  // ~68 minutos por vuelta
+    const GrafoCSR& red;
+
+    // Para un destino d, siguiente[u] es la arista que toma un vehiculo en u
+    // para llegar a d por el camino mas corto (-1 si no hay camino)
+    static void arbolHaciaDestino(const GrafoCSR& inversa, int d, std::vector<float>& dist, int* siguiente);
+
+    static int duracionSeg(float w) {
+        return std::max(1, static_cast<int>(lround(w * 60.0f)));
+    }
+
+public:
+    explicit SimuladorTrafico(const GrafoCSR& r) : red(r) {}
+
+    ResultadoSimulacion simular(const std::vector<Vehiculo>& vehiculos, int hilos);
+};
+
+// Red sintetica en rejilla lado x lado con calles en ambos sentidos y
+// pesos aleatorios entre 1 y 10, para benchmarks. Cada nodo lleva como
+// coordenadas su columna y su fila.
+void generarRejilla(Grafo& g, int lado, unsigned semilla);
+
+// Asignacion de trafico en equilibrio de usuario (Wardrop) por Frank-Wolfe.
+// La demanda son los pares origen/destino de los vehiculos y el tiempo de cada
+// arista sigue la funcion BPR t = w * (1 + alfa * (x / capacidad)^beta), con
+// la capacidad propia de cada arista (la indicada al construir, salvo las que
+// se fijen por tramo).
+// Cada iteracion hace una asignacion todo-o-nada sobre los tiempos actuales,
+// repartiendo los origenes entre hilos, y una busqueda lineal por biseccion.
+class AsignacionEquilibrio {
+private:
+    const GrafoCSR& red;
+    std::vector<float> capacidad;  // por arista, indexada como red.destino
+    float alfa;
+    float beta;
+    int hilos;
+    std::vector<std::pair<int, std::vector<std::pair<int, int>>>> demanda;  // origen -> (destino, vehiculos)
+
+    float tiempoBPR(int k, double x) const {
+        return static_cast<float>(red.peso[k] * (1.0 + alfa * pow(x / capacidad[k], beta)));
+    }
+
+    // Todo-o-nada: carga toda la demanda en las rutas mas cortas con 'costo'.
+    // Devuelve la suma de demanda por costo de ruta (tiempo total si todos
+    // tomaran su ruta mas corta).
+    double todoONada(const std::vector<float>& costo, std::vector<double>& flujo) const;
+
+public:
+    struct Iteracion {
+        int numero;
+        double gap;
+        double paso;
+        double tiempoTotal;
+    };
+
+    std::vector<double> flujo;
+    std::vector<Iteracion> historial;
+    int viajesSinRuta = 0;
+
+    // 'cap' es la capacidad de todas las aristas mientras no se fije otra por tramo
+    AsignacionEquilibrio(const GrafoCSR& r, float cap, int numHilos, float a = 0.15f, float b = 4.0f)
+        : red(r), capacidad(r.numAristas(), std::max(cap, 1e-3f)), alfa(a), beta(b), hilos(std::max(numHilos, 1)) {}
+
+    // Capacidad de las aristas from -> to (ids del Grafo; todas las paralelas).
+    // Devuelve cuantas aristas cambio: 0 si el tramo no existe o 'cap' no es valida.
+    int fijarCapacidad(int from, int to, float cap);
+
+    // Lee lineas "origen;destino;capacidad" (ids del Grafo; '#' comenta) y
+    // cuenta en 'ignoradas' las mal formadas o de tramos inexistentes.
+    // Devuelve false si no se pudo abrir.
+    bool cargarCapacidades(const std::string& filename, int& ignoradas);
+
+    void cargarDemanda(const std::vector<Vehiculo>& vehiculos);
+
+    // Itera hasta que el gap relativo baje de 'gapObjetivo' o se agoten las iteraciones
+    void resolver(int maxIter, double gapObjetivo);
+
+    float tiempoActual(int k) const { return tiempoBPR(k, flujo[k]); }
+    float getCapacidad(int k) const { return capacidad[k]; }
+};
+
+// Rutas alternativas entre dos nodos.
+// - Yen: las k rutas sin ciclos mas cortas. Una sola busqueda hacia atras
+//   desde el destino da la distancia exacta de cada nodo al destino, que se
+//   reutiliza como heuristica A* en todas las busquedas de desvio (al quitar
+//   nodos o aristas las distancias solo crecen, asi que sigue siendo valida).
+// - Penalizacion: repite Dijkstra encareciendo las aristas ya usadas y acepta
+//   rutas que se solapen poco con las anteriores y no se alarguen demasiado.
+class RutasAlternativas {
+private:
+    const GrafoCSR& red;
+    GrafoCSR inversa;
+
+    // Espacio de trabajo reutilizable; las marcas evitan reinicializar arreglos
+    std::vector<float> dist, h;
+    std::vector<int> predArista, marca, bloqueado;
+    int marcaActual = 0;
+    int marcaBloqueo = 0;
+
+    struct Camino {
+        float costo;
+        std::vector<int> aristas;
+        std::vector<int> nodos;
+    };
+
+    void heuristicaHacia(int t);
+
+    // A* de s a t evitando nodos bloqueados y las salidas de s hacia 'prohibidos'
+    bool desvio(int s, int t, const std::vector<int>& prohibidos, Camino& res);
+
+    void completarNodos(int s, Camino& c) const {
+        c.nodos.assign(1, s);
+        for (int k : c.aristas) c.nodos.push_back(red.destino[k]);
+    }
+
+    static Ruta aRuta(const Camino& c) { return Ruta{c.costo, c.nodos}; }
+
+public:
+    explicit RutasAlternativas(const GrafoCSR& r)
+        : red(r), inversa(r.transpuesto()), dist(r.numNodos), predArista(r.numNodos),
+          marca(r.numNodos, 0), bloqueado(r.numNodos, 0) {}
+
+    std::vector<Ruta> yen(int s, int t, int k);
+
+    // maxSolape: fraccion maxima de la longitud de una ruta compartida con
+    // cualquier ruta ya aceptada; maxEstiramiento: costo maximo relativo a la optima
+    std::vector<Ruta> penalizacion(int s, int t, int k, float factor, float maxSolape, float maxEstiramiento);
+};
+
+}  // namespace trafico
+
+#endif
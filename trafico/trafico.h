@@ -0,0 +1,20 @@
+// Biblioteca de trafico urbano: red vial, rutas, recorridos, simulacion y
+// registro de vehiculos. Las funciones devuelven datos y no escriben en
+// consola; la presentacion queda a cargo de quien las usa (ver el CLI en
+// SistemaTraficoU4.cpp).
+#ifndef TRAFICO_TRAFICO_H
+#define TRAFICO_TRAFICO_H
+
+#include "comun.h"
+#include "metricas.h"
+#include "grafo.h"
+#include "versionado.h"
+#include "csr.h"
+#include "vehiculos.h"
+#include "simulacion.h"
+#include "bitacora.h"
+#include "servidor.h"
+#include "importador.h"
+#include "reporte.h"
+
+#endif
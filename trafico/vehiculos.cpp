@@ -0,0 +1,480 @@
+#include "vehiculos.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace trafico {
+
+vector<Vehiculo> vehiculosEnRed(const GrafoCSR& red, vector<Vehiculo> vehiculos) {
+    for (auto& v : vehiculos) {
+        v.origen = red.interno(v.origen);
+        v.destino = red.interno(v.destino);
+    }
+    return vehiculos;
+}
+
+bool parseEventoVehiculo(string line, EventoVehiculo& ev) {
+    if (line.empty() || line[0] == '#') return false;
+    line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+
+    vector<string> campos;
+    stringstream ss(line);
+    string token;
+    while (getline(ss, token, ';')) campos.push_back(token);
+    if (campos.empty()) return false;
+    const string& type = campos[0];
+
+    try {
+        if (type == "V" && campos.size() >= 7 && !campos[1].empty()) {
+            ev.alta = true;
+            ev.v.id = campos[1];
+            ev.v.tipo = campos[2];
+            ev.v.placa = campos[3];
+            ev.v.origen = stoi(campos[4]);
+            ev.v.destino = stoi(campos[5]);
+            ev.v.horaEntrada = campos[6];
+            return true;
+        } else if (type == "B" && campos.size() >= 2 && !campos[1].empty()) {
+            ev.alta = false;
+            ev.v = Vehiculo();
+            ev.v.id = campos[1];
+            return true;
+        }
+    } catch (const exception&) {
+        return false;
+    }
+    return false;
+}
+
+void HashTable::indexar(Vehiculo* v) {
+    idxPlaca[v->placa].insert(v);
+    idxOrigen[v->origen].insert(v);
+    idxDestino[v->destino].insert(v);
+    idxTipo[v->tipo].insert(v);
+    int minuto = horaAMinutos(v->horaEntrada);
+    if (minuto >= 0) {
+        idxHora[minuto].insert(v);
+        fenwickSumar(minuto, 1);
+    }
+}
+
+void HashTable::desindexar(Vehiculo* v) {
+    quitarDeIndice(idxPlaca, v->placa, v);
+    quitarDeIndice(idxOrigen, v->origen, v);
+    quitarDeIndice(idxDestino, v->destino, v);
+    quitarDeIndice(idxTipo, v->tipo, v);
+    int minuto = horaAMinutos(v->horaEntrada);
+    if (minuto >= 0 && idxHora[minuto].erase(v)) fenwickSumar(minuto, -1);
+}
+
+void HashTable::insert(const string& key, const Vehiculo& v) {
+    MedicionOperacion med(Operacion::HashInsertar);
+    int idx = hashFunc(key);
+
+    for (auto& p : table[idx]) {
+        med.conteo.sondeos++;
+        if (p.first == key) {
+            desindexar(&p.second);
+            p.second = v;
+            indexar(&p.second);
+            return;
+        }
+    }
+
+    table[idx].push_back({key, v});
+    indexar(&table[idx].back().second);
+    count++;
+}
+
+Vehiculo* HashTable::search(const string& key) {
+    MedicionOperacion med(Operacion::HashBuscar);
+    int idx = hashFunc(key);
+    for (auto& p : table[idx]) {
+        med.conteo.sondeos++;
+        if (p.first == key) return &p.second;
+    }
+    return nullptr;
+}
+
+void HashTable::remove(const string& key) {
+    MedicionOperacion med(Operacion::HashBorrar);
+    int idx = hashFunc(key);
+    auto it = table[idx].begin();
+    while (it != table[idx].end()) {
+        med.conteo.sondeos++;
+        if (it->first == key) {
+            desindexar(&it->second);
+            table[idx].erase(it);
+            count--;
+            return;
+        }
+        ++it;
+    }
+}
+
+vector<Vehiculo*> HashTable::searchByHora(int desde, int hasta) {
+    MedicionOperacion med(Operacion::HashConsulta);
+    vector<Vehiculo*> res;
+    if (desde < 0 || hasta < 0 || desde >= MINUTOS_DIA || hasta >= MINUTOS_DIA) return res;
+    res.reserve(contarPorHora(desde, hasta));
+    int n = desde <= hasta ? hasta - desde + 1 : MINUTOS_DIA - desde + hasta + 1;
+    for (int k = 0; k < n; ++k) {
+        for (Vehiculo* v : idxHora[(desde + k) % MINUTOS_DIA]) res.push_back(v);
+    }
+    return res;
+}
+
+vector<int> HashTable::conteoPorVentanas(int desde, int hasta, int ventana) const {
+    vector<int> conteos;
+    if (ventana <= 0 || desde < 0 || hasta < 0 || desde >= MINUTOS_DIA || hasta >= MINUTOS_DIA) return conteos;
+    int n = desde <= hasta ? hasta - desde + 1 : MINUTOS_DIA - desde + hasta + 1;
+    for (int k = 0; k < n; k += ventana) {
+        int ini = (desde + k) % MINUTOS_DIA;
+        int fin = (desde + min(k + ventana, n) - 1) % MINUTOS_DIA;
+        conteos.push_back(contarPorHora(ini, fin));
+    }
+    return conteos;
+}
+
+vector<UsoMemoria> HashTable::reporteMemoria() const {
+    vector<UsoMemoria> rep;
+
+    UsoMemoria cubetas{"Cubetas"};
+    contarVector(cubetas, table);
+    rep.push_back(cubetas);
+
+    // Cada nodo de std::list lleva dos enlaces ademas del par (clave, vehiculo)
+    UsoMemoria listas{"Nodos de lista"};
+    UsoMemoria cadenas{"Cadenas"};
+    for (const auto& lst : table) {
+        for (const auto& p : lst) {
+            listas.vivos += 2 * sizeof(void*) + sizeof(p);
+            listas.asignaciones++;
+            for (const string* str : {&p.first, &p.second.id, &p.second.tipo, &p.second.placa, &p.second.horaEntrada}) {
+                contarString(cadenas, *str);
+            }
+        }
+    }
+    rep.push_back(listas);
+    rep.push_back(cadenas);
+
+    UsoMemoria placa{"Indice placa"};
+    contarHash(placa, idxPlaca);
+    for (const auto& par : idxPlaca) {
+        contarString(placa, par.first);
+        contarHash(placa, par.second);
+    }
+    rep.push_back(placa);
+
+    UsoMemoria nodosIdx{"Indices origen/destino"};
+    contarHash(nodosIdx, idxOrigen);
+    contarHash(nodosIdx, idxDestino);
+    for (const auto& par : idxOrigen) contarHash(nodosIdx, par.second);
+    for (const auto& par : idxDestino) contarHash(nodosIdx, par.second);
+    rep.push_back(nodosIdx);
+
+    UsoMemoria tipo{"Indice tipo"};
+    contarHash(tipo, idxTipo);
+    for (const auto& par : idxTipo) {
+        contarString(tipo, par.first);
+        contarHash(tipo, par.second);
+    }
+    rep.push_back(tipo);
+
+    UsoMemoria hora{"Indice hora"};
+    contarVector(hora, idxHora);
+    for (const auto& bucket : idxHora) contarHash(hora, bucket);
+    contarVector(hora, fenwickHora);
+    rep.push_back(hora);
+    return rep;
+}
+
+void HashTable::liberarHolgura() {
+    for (auto& lst : table) {
+        for (auto& p : lst) {
+            for (string* str : {&p.first, &p.second.id, &p.second.tipo, &p.second.placa, &p.second.horaEntrada}) {
+                str->shrink_to_fit();
+            }
+        }
+    }
+    ajustarCubetas(idxPlaca);
+    ajustarCubetas(idxOrigen);
+    ajustarCubetas(idxDestino);
+    ajustarCubetas(idxTipo);
+    for (auto& par : idxPlaca) ajustarCubetas(par.second);
+    for (auto& par : idxOrigen) ajustarCubetas(par.second);
+    for (auto& par : idxDestino) ajustarCubetas(par.second);
+    for (auto& par : idxTipo) ajustarCubetas(par.second);
+    for (auto& bucket : idxHora) ajustarCubetas(bucket);
+}
+
+vector<Vehiculo> HashTable::todos() const {
+    vector<Vehiculo> res;
+    res.reserve(count);
+    for (const auto& lst : table) {
+        for (const auto& p : lst) res.push_back(p.second);
+    }
+    return res;
+}
+
+EstadisticasHash HashTable::estadisticas() const {
+    EstadisticasHash e;
+    e.tamTabla = size;
+    e.vehiculos = count;
+    for (const auto& bucket : table) {
+        if (!bucket.empty()) {
+            e.bucketsUsados++;
+            e.cadenaMasLarga = max(e.cadenaMasLarga, static_cast<int>(bucket.size()));
+        }
+    }
+    e.placas = idxPlaca.size();
+    e.origenes = idxOrigen.size();
+    e.destinos = idxDestino.size();
+    e.tipos = idxTipo.size();
+    return e;
+}
+
+bool HashTable::cargar(const string& filename, int& cargados) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+
+    TramoTraza tramo("cargar_vehiculos");
+    string line;
+    EventoVehiculo ev;
+    while (getline(file, line)) {
+        if (parseEventoVehiculo(line, ev) && ev.alta) {
+            insert(ev.v.id, ev.v);
+            cargados++;
+        }
+    }
+    return true;
+}
+
+vector<string> HashTable::validarContra(const Grafo& g, int hilos) const {
+    TramoTraza tramo("validar_vehiculos");
+    hilos = max(1, min(hilos, size));
+    vector<vector<string>> invalidos(hilos);
+    vector<thread> trabajadores;
+    for (int t = 0; t < hilos; ++t) {
+        trabajadores.emplace_back([&, t]() {
+            int desde = static_cast<int>(static_cast<long long>(size) * t / hilos);
+            int hasta = static_cast<int>(static_cast<long long>(size) * (t + 1) / hilos);
+            for (int b = desde; b < hasta; ++b) {
+                for (const auto& p : table[b]) {
+                    if (!g.existe(p.second.origen) || !g.existe(p.second.destino)) invalidos[t].push_back(p.first);
+                }
+            }
+        });
+    }
+    for (auto& t : trabajadores) t.join();
+
+    vector<string> todos;
+    for (auto& parte : invalidos) todos.insert(todos.end(), parte.begin(), parte.end());
+    sort(todos.begin(), todos.end());
+    return todos;
+}
+
+void HashTable::aplicarLote(const vector<EventoVehiculo>& lote, int& altas, int& bajas) {
+    TramoTraza tramo("aplicar_lote");
+    unordered_map<string, size_t> ultimo;
+    ultimo.reserve(lote.size());
+    for (size_t i = 0; i < lote.size(); ++i) ultimo[lote[i].v.id] = i;
+
+    for (size_t i = 0; i < lote.size(); ++i) {
+        const EventoVehiculo& ev = lote[i];
+        if (ultimo[ev.v.id] != i) continue;
+        if (ev.alta) {
+            insert(ev.v.id, ev.v);
+            altas++;
+        } else {
+            remove(ev.v.id);
+            bajas++;
+        }
+    }
+}
+
+bool HashTable::guardar(const string& filename) const {
+    TramoTraza tramo("guardar_vehiculos");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "# idVehiculo;tipo;placa;origen;destino;horaEntrada\n";
+    for (const auto& lst : table) {
+        for (const auto& p : lst) {
+            const Vehiculo& v = p.second;
+            file << "V;" << v.id << ";" << v.tipo << ";" << v.placa << ";" 
+                 << v.origen << ";" << v.destino << ";" << v.horaEntrada << "\n";
+        }
+    }
+    file.close();
+    return !file.fail();
+}
+
+IngestorVehiculos::~IngestorVehiculos() { cerrar(); }
+
+bool IngestorVehiculos::abrir(const string& fuente) {
+    cerrar();
+    fd = ::open(fuente.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    esFifo = fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+    return true;
+}
+
+void IngestorVehiculos::cerrar() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    pendiente.clear();
+}
+
+bool IngestorVehiculos::leerLote(vector<EventoVehiculo>& lote, size_t maxLote, int esperaMs) {
+    lote.clear();
+    if (fd < 0) return false;
+
+    // Primero las lineas completas que quedaron de la llamada anterior
+    extraerLineas(lote, maxLote);
+    auto limite = chrono::steady_clock::now() + chrono::milliseconds(esperaMs);
+    while (lote.size() < maxLote) {
+        if (esFifo) {
+            // read bloquearia hasta que el escritor mande mas datos o cierre:
+            // se espera con poll y al vencer el plazo se entrega el lote parcial.
+            // Sin plazo (0) se bloquea solo mientras el lote este vacio; con
+            // datos ya leidos se entrega lo que haya sin esperar mas.
+            int espera = lote.empty() ? -1 : 0;
+            if (esperaMs > 0) {
+                auto restante = chrono::duration_cast<chrono::milliseconds>(limite - chrono::steady_clock::now());
+                espera = static_cast<int>(max<long long>(restante.count(), 0));
+            }
+            pollfd pfd{fd, POLLIN, 0};
+            int listos = espera != 0 ? poll(&pfd, 1, espera) : 0;
+            if (listos < 0) continue;
+            if (listos == 0) {
+                // Sin nada recibido la ingesta termina; la linea a medias ya no se completara
+                if (lote.empty() && !pendiente.empty()) {
+                    procesarLinea(pendiente, lote);
+                    pendiente.clear();
+                }
+                return !lote.empty();
+            }
+        }
+        ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        if (n < 0) return !lote.empty();
+        if (n == 0) {
+            // Sin datos: un FIFO sin escritores termino; un archivo puede seguir creciendo
+            if (!lote.empty()) return true;
+            if (esFifo || chrono::steady_clock::now() >= limite) {
+                if (!pendiente.empty()) procesarLinea(pendiente, lote);
+                pendiente.clear();
+                return !lote.empty();
+            }
+            this_thread::sleep_for(chrono::milliseconds(50));
+            continue;
+        }
+        pendiente.append(buffer.data(), n);
+        extraerLineas(lote, maxLote);
+    }
+    return true;
+}
+
+void IngestorVehiculos::extraerLineas(vector<EventoVehiculo>& lote, size_t maxLote) {
+    size_t ini = 0, fin;
+    while (lote.size() < maxLote && (fin = pendiente.find('\n', ini)) != string::npos) {
+        procesarLinea(pendiente.substr(ini, fin - ini), lote);
+        ini = fin + 1;
+    }
+    pendiente.erase(0, ini);
+}
+
+void IngestorVehiculos::procesarLinea(const string& line, vector<EventoVehiculo>& lote) {
+    EventoVehiculo ev;
+    if (parseEventoVehiculo(line, ev)) {
+        lote.push_back(move(ev));
+    } else if (!line.empty() && line[0] != '#' && line.find_first_not_of(" \t\r") != string::npos) {
+        lineasInvalidas++;
+    }
+}
+
+uint64_t HashTableConcurrente::hashFunc(const string& key) {
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void HashTableConcurrente::crecer(Franja& f) {
+    vector<list<pair<string, Vehiculo>>> nueva(f.table.size() * 2);
+    for (auto& bucket : f.table) {
+        while (!bucket.empty()) {
+            auto& destino = nueva[(hashFunc(bucket.front().first) & 0xffffffffULL) % nueva.size()];
+            destino.splice(destino.end(), bucket, bucket.begin());
+        }
+    }
+    f.table.swap(nueva);
+}
+
+void HashTableConcurrente::insert(const string& key, const Vehiculo& v) {
+    uint64_t h = hashFunc(key);
+    Franja& f = franjaDe(h);
+    unique_lock<shared_mutex> lock(f.mtx);
+    auto& bucket = f.table[bucketDe(f, h)];
+    for (auto& p : bucket) {
+        if (p.first == key) {
+            p.second = v;
+            return;
+        }
+    }
+    bucket.push_back({key, v});
+    if (++f.count > static_cast<int>(f.table.size())) crecer(f);
+    total.fetch_add(1, memory_order_relaxed);
+}
+
+bool HashTableConcurrente::search(const string& key, Vehiculo& out) const {
+    uint64_t h = hashFunc(key);
+    const Franja& f = franjaDe(h);
+    shared_lock<shared_mutex> lock(f.mtx);
+    for (const auto& p : f.table[bucketDe(f, h)]) {
+        if (p.first == key) {
+            out = p.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HashTableConcurrente::contains(const string& key) const {
+    uint64_t h = hashFunc(key);
+    const Franja& f = franjaDe(h);
+    shared_lock<shared_mutex> lock(f.mtx);
+    for (const auto& p : f.table[bucketDe(f, h)]) {
+        if (p.first == key) return true;
+    }
+    return false;
+}
+
+bool HashTableConcurrente::remove(const string& key) {
+    uint64_t h = hashFunc(key);
+    Franja& f = franjaDe(h);
+    unique_lock<shared_mutex> lock(f.mtx);
+    auto& bucket = f.table[bucketDe(f, h)];
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (it->first == key) {
+            bucket.erase(it);
+            f.count--;
+            total.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+string registroVehiculo(const Vehiculo& v) {
+    return "V;" + v.id + ";" + v.tipo + ";" + v.placa + ";" + to_string(v.origen) + ";"
+        + to_string(v.destino) + ";" + v.horaEntrada;
+}
+
+}  // namespace trafico
@@ -0,0 +1,278 @@
+// Registro de vehiculos: tabla hash, indices, eventos e ingesta.
+#ifndef TRAFICO_VEHICULOS_H
+#define TRAFICO_VEHICULOS_H
+
+#include "csr.h"
+
+namespace trafico {
+
+// Estructura para Vehículo
+struct Vehiculo {
+    std::string id, tipo, placa;
+    int origen, destino;
+    std::string horaEntrada;
+};
+
+// Vehiculos con origen y destino traducidos a los indices internos de la red
+std::vector<Vehiculo> vehiculosEnRed(const GrafoCSR& red, std::vector<Vehiculo> vehiculos);
+
+// Evento de la bitacora de vehiculos: "V;id;tipo;placa;origen;destino;hora"
+// da de alta (o reemplaza) y "B;id" da de baja
+struct EventoVehiculo {
+    bool alta;
+    Vehiculo v;
+};
+
+// Interpreta una linea de eventos; devuelve false si es comentario o invalida
+bool parseEventoVehiculo(std::string line, EventoVehiculo& ev);
+
+// Resumen de ocupacion de la tabla hash y de sus indices secundarios
+struct EstadisticasHash {
+    int tamTabla = 0;
+    int vehiculos = 0;
+    int bucketsUsados = 0;
+    int cadenaMasLarga = 0;
+    size_t placas = 0;
+    size_t origenes = 0;
+    size_t destinos = 0;
+    size_t tipos = 0;
+};
+
+// Tabla Hash con encadenamiento
+class HashTable {
+private:
+    std::vector<std::list<std::pair<std::string, Vehiculo>>> table;
+    int size;
+    int count;
+
+    // Indices secundarios (apuntan a los elementos de las listas, que no se mueven)
+    std::unordered_map<std::string, std::unordered_set<Vehiculo*>> idxPlaca;  // puede haber placas repetidas
+    std::unordered_map<int, std::unordered_set<Vehiculo*>> idxOrigen;
+    std::unordered_map<int, std::unordered_set<Vehiculo*>> idxDestino;
+    std::unordered_map<std::string, std::unordered_set<Vehiculo*>> idxTipo;
+
+    // Indice temporal: un bucket por minuto del dia y un arbol de Fenwick
+    // con los conteos para responder ventanas en O(log n)
+    std::vector<std::unordered_set<Vehiculo*>> idxHora;
+    std::vector<int> fenwickHora;
+
+    void fenwickSumar(int minuto, int delta) {
+        for (int i = minuto + 1; i <= MINUTOS_DIA; i += i & -i) fenwickHora[i] += delta;
+    }
+
+    int fenwickPrefijo(int minuto) const {
+        int total = 0;
+        for (int i = minuto + 1; i > 0; i -= i & -i) total += fenwickHora[i];
+        return total;
+    }
+
+    // Cuenta en [desde, hasta] sin cruzar la medianoche
+    int contarTramo(int desde, int hasta) const {
+        if (desde > hasta) return 0;
+        return fenwickPrefijo(hasta) - (desde > 0 ? fenwickPrefijo(desde - 1) : 0);
+    }
+
+    int hashFunc(const std::string& key) {
+        int hash = 0;
+        for (char c : key) {
+            hash = (hash * 31 + c) % size;
+        }
+        return hash;
+    }
+
+    void indexar(Vehiculo* v);
+
+    void desindexar(Vehiculo* v);
+
+    template <typename K>
+    static void quitarDeIndice(std::unordered_map<K, std::unordered_set<Vehiculo*>>& idx, const K& clave, Vehiculo* v) {
+        auto it = idx.find(clave);
+        if (it == idx.end()) return;
+        it->second.erase(v);
+        if (it->second.empty()) idx.erase(it);
+    }
+
+    template <typename K>
+    static std::vector<Vehiculo*> consultarIndice(const std::unordered_map<K, std::unordered_set<Vehiculo*>>& idx, const K& clave) {
+        auto it = idx.find(clave);
+        if (it == idx.end()) return {};
+        return std::vector<Vehiculo*>(it->second.begin(), it->second.end());
+    }
+
+public:
+    HashTable(int sz = 100) : size(sz), count(0), idxHora(MINUTOS_DIA), fenwickHora(MINUTOS_DIA + 1, 0) { 
+        table.resize(size); 
+    }
+
+    // Los indices guardan punteros a las listas propias; no se permite copiar
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    void insert(const std::string& key, const Vehiculo& v);
+
+    Vehiculo* search(const std::string& key);
+
+    void remove(const std::string& key);
+
+    // Consultas por indices secundarios
+    std::vector<Vehiculo*> searchByPlaca(const std::string& placa) {
+        MedicionOperacion med(Operacion::HashConsulta);
+        return consultarIndice(idxPlaca, placa);
+    }
+
+    std::vector<Vehiculo*> searchByOrigen(int nodo) {
+        MedicionOperacion med(Operacion::HashConsulta);
+        return consultarIndice(idxOrigen, nodo);
+    }
+
+    std::vector<Vehiculo*> searchByDestino(int nodo) {
+        MedicionOperacion med(Operacion::HashConsulta);
+        return consultarIndice(idxDestino, nodo);
+    }
+
+    std::vector<Vehiculo*> searchByTipo(const std::string& tipo) {
+        MedicionOperacion med(Operacion::HashConsulta);
+        return consultarIndice(idxTipo, tipo);
+    }
+
+    // Consultas por hora de entrada, en minutos del dia e inclusivas.
+    // Si desde > hasta la ventana cruza la medianoche (p. ej. 22:00 - 02:00);
+    // fuera de [0, MINUTOS_DIA) no hay resultados.
+    std::vector<Vehiculo*> searchByHora(int desde, int hasta);
+
+    int contarPorHora(int desde, int hasta) const {
+        if (desde < 0 || hasta < 0 || desde >= MINUTOS_DIA || hasta >= MINUTOS_DIA) return 0;
+        if (desde <= hasta) return contarTramo(desde, hasta);
+        return contarTramo(desde, MINUTOS_DIA - 1) + contarTramo(0, hasta);
+    }
+
+    // Conteos por ventanas consecutivas de 'ventana' minutos a partir de 'desde'
+    std::vector<int> conteoPorVentanas(int desde, int hasta, int ventana) const;
+
+    // Memoria por componente: cubetas, nodos de las listas, cadenas fuera de
+    // linea e indices secundarios
+    std::vector<UsoMemoria> reporteMemoria() const;
+
+    // Ajusta las cadenas a su tamano y reduce las cubetas de los indices al
+    // minimo para su factor de carga (tras muchas bajas quedan sobredimensionadas)
+    void liberarHolgura();
+
+    std::vector<Vehiculo> todos() const;
+
+    EstadisticasHash estadisticas() const;
+
+    // Agrega los vehiculos del archivo y suma en 'cargados' los leidos; no
+    // escribe en consola, asi que puede correr en otro hilo mientras se lee
+    // la red. Devuelve false si no se pudo abrir.
+    bool cargar(const std::string& filename, int& cargados);
+
+    bool cargar(const std::string& filename) {
+        int cargados = 0;
+        return cargar(filename, cargados);
+    }
+
+    // IDs de los vehiculos cuyo origen o destino no existe en la red. Los
+    // buckets se reparten entre los hilos; la tabla y la red solo se leen.
+    std::vector<std::string> validarContra(const Grafo& g, int hilos) const;
+
+    // Aplica un lote de eventos en una sola pasada: si un mismo vehiculo
+    // aparece varias veces en el lote solo se aplica su ultimo evento.
+    void aplicarLote(const std::vector<EventoVehiculo>& lote, int& altas, int& bajas);
+
+    bool guardar(const std::string& filename) const;
+};
+
+// Lectura incremental de eventos de vehiculos desde un archivo que sigue
+// creciendo (como "tail -f") o desde un FIFO. Las lineas incompletas se
+// guardan hasta que llega el resto; los eventos se agrupan en lotes.
+class IngestorVehiculos {
+private:
+    int fd;
+    bool esFifo;
+    std::string pendiente;  // bytes leidos aun sin procesar (lineas completas y una a medias)
+    std::vector<char> buffer;
+
+public:
+    int lineasInvalidas = 0;
+
+    IngestorVehiculos() : fd(-1), esFifo(false), buffer(1 << 16) {}
+    ~IngestorVehiculos();
+
+    bool abrir(const std::string& fuente);
+
+    void cerrar();
+
+    // Llena 'lote' con hasta maxLote eventos, esperando a lo sumo 'esperaMs'
+    // milisegundos (0 = sin plazo: hasta el final del archivo o del FIFO); al
+    // vencer la espera devuelve el lote parcial. Las lineas leidas que no caben
+    // quedan para la siguiente llamada. Devuelve false cuando la fuente termino
+    // (FIFO sin escritores) o vencio la espera sin recibir nada.
+    bool leerLote(std::vector<EventoVehiculo>& lote, size_t maxLote, int esperaMs);
+
+private:
+    // Procesa las lineas completas de 'pendiente' hasta llenar el lote
+    void extraerLineas(std::vector<EventoVehiculo>& lote, size_t maxLote);
+
+    void procesarLinea(const std::string& line, std::vector<EventoVehiculo>& lote);
+};
+
+// Tabla Hash concurrente para ingesta desde varios hilos.
+// Las claves se reparten en franjas (lock striping); cada franja tiene su propia
+// tabla con encadenamiento y un shared_mutex: los escritores bloquean solo su
+// franja y los lectores de una misma franja avanzan en paralelo. Cada franja
+// arranca con su parte de la capacidad esperada y duplica sus buckets, bajo su
+// propio candado exclusivo, cuando tiene mas claves que buckets.
+// Las lecturas no son optimistas (seqlock) ni sin candado: copiar el vehiculo
+// mientras un escritor libera sus cadenas exigiria diferir la liberacion
+// (epocas o RCU), que esta tabla no tiene. Se paga el shared_lock de la franja.
+class HashTableConcurrente {
+private:
+    struct alignas(64) Franja {
+        mutable std::shared_mutex mtx;
+        std::vector<std::list<std::pair<std::string, Vehiculo>>> table;
+        int count = 0;
+    };
+
+    static constexpr int MIN_BUCKETS_FRANJA = 8;
+
+    std::vector<Franja> franjas;
+    std::atomic<int> total;
+
+    // FNV-1a: los bits altos eligen la franja y los bajos el bucket
+    static uint64_t hashFunc(const std::string& key);
+
+    Franja& franjaDe(uint64_t h) { return franjas[(h >> 32) % franjas.size()]; }
+    const Franja& franjaDe(uint64_t h) const { return franjas[(h >> 32) % franjas.size()]; }
+    static size_t bucketDe(const Franja& f, uint64_t h) { return (h & 0xffffffffULL) % f.table.size(); }
+
+    // Duplica los buckets de la franja; se llama con su candado exclusivo tomado
+    static void crecer(Franja& f);
+
+public:
+    // 'capacidad' es el numero de vehiculos esperado y se reparte entre las franjas
+    HashTableConcurrente(int numFranjas = 64, int capacidad = 100)
+        : franjas(std::max(numFranjas, 1)), total(0) {
+        int n = static_cast<int>(franjas.size());
+        int porFranja = std::max((std::max(capacidad, 0) + n - 1) / n, MIN_BUCKETS_FRANJA);
+        for (auto& f : franjas) f.table.resize(porFranja);
+    }
+
+    // Inserta o reemplaza, igual que HashTable::insert
+    void insert(const std::string& key, const Vehiculo& v);
+
+    // Copia el vehiculo en 'out': un puntero no seria valido al soltar el candado
+    bool search(const std::string& key, Vehiculo& out) const;
+
+    bool contains(const std::string& key) const;
+
+    bool remove(const std::string& key);
+
+    int getCount() const { return total.load(std::memory_order_relaxed); }
+    int getNumFranjas() const { return static_cast<int>(franjas.size()); }
+};
+
+std::string registroVehiculo(const Vehiculo& v);
+
+}  // namespace trafico
+
+#endif
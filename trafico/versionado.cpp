@@ -0,0 +1,163 @@
+#include "versionado.h"
+
+using namespace std;
+
+namespace trafico {
+
+vector<Ruta> VersionGrafo::rutasDesde(int s, const vector<int>& destinos) const {
+    const float INF = numeric_limits<float>::infinity();
+    vector<Ruta> rutas(destinos.size(), Ruta{INF, {}});
+    if (!existe(s)) return rutas;
+
+    vector<float> dist(numNodos, INF);
+    vector<int> previo(numNodos, -1);
+    vector<bool> visit(numNodos, false);
+    vector<bool> buscado(numNodos, false);
+    int pendientes = 0;
+    for (int e : destinos) {
+        if (existe(e) && !buscado[e]) {
+            buscado[e] = true;
+            pendientes++;
+        }
+    }
+    dist[s] = 0;
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<pair<float, int>>> pq;
+    pq.push({0, s});
+
+    while (!pq.empty() && pendientes > 0) {
+        int u = pq.top().second;
+        pq.pop();
+        if (visit[u]) continue;
+        visit[u] = true;
+        if (buscado[u]) pendientes--;
+
+        for (const auto& a : nodo(u).adj) {
+            if (!visit[a.to] && dist[u] + a.w < dist[a.to]) {
+                dist[a.to] = dist[u] + a.w;
+                previo[a.to] = u;
+                pq.push({dist[a.to], a.to});
+            }
+        }
+    }
+
+    for (size_t i = 0; i < destinos.size(); ++i) {
+        int e = destinos[i];
+        if (!existe(e) || dist[e] == INF) continue;
+        rutas[i].distancia = dist[e];
+        for (int at = e; at != -1; at = previo[at]) rutas[i].camino.push_back(at);
+        reverse(rutas[i].camino.begin(), rutas[i].camino.end());
+    }
+    return rutas;
+}
+
+vector<int> VersionGrafo::recorrido(int s, bool anchura) const {
+    vector<int> orden;
+    if (!existe(s)) return orden;
+    vector<bool> visit(numNodos, false);
+    if (anchura) {
+        queue<int> q;
+        q.push(s);
+        visit[s] = true;
+        while (!q.empty()) {
+            int u = q.front();
+            q.pop();
+            orden.push_back(u);
+            for (const auto& a : nodo(u).adj) {
+                if (!visit[a.to]) {
+                    visit[a.to] = true;
+                    q.push(a.to);
+                }
+            }
+        }
+    } else {
+        // Pila explicita de (nodo, siguiente arista) para no desbordar la
+        // pila del hilo en redes grandes
+        vector<pair<int, size_t>> pila{{s, 0}};
+        visit[s] = true;
+        orden.push_back(s);
+        while (!pila.empty()) {
+            auto& [u, k] = pila.back();
+            const auto& adj = nodo(u).adj;
+            if (k == adj.size()) {
+                pila.pop_back();
+                continue;
+            }
+            int v = adj[k++].to;
+            if (!visit[v]) {
+                visit[v] = true;
+                orden.push_back(v);
+                pila.push_back({v, 0});
+            }
+        }
+    }
+    return orden;
+}
+
+VersionGrafo::Bloque& EdicionGrafo::bloqueMutable(int b) {
+    if (!bloqueCopiado[b]) {
+        nueva->bloques[b] = make_shared<VersionGrafo::Bloque>(*nueva->bloques[b]);
+        bloqueCopiado[b] = true;
+    }
+    return *nueva->bloques[b];
+}
+
+NodoVersion& EdicionGrafo::nodoMutable(int id) {
+    auto& ptr = bloqueMutable(id / VersionGrafo::TAM_BLOQUE)[id % VersionGrafo::TAM_BLOQUE];
+    if (nodoCopiado.insert(id).second) ptr = make_shared<NodoVersion>(*ptr);
+    return *ptr;
+}
+
+void EdicionGrafo::altaNodo(int id, const string& nombre) {
+    if (id < 0) return;
+    while (id >= nueva->numNodos) {
+        if (nueva->numNodos % VersionGrafo::TAM_BLOQUE == 0) {
+            nueva->bloques.push_back(make_shared<VersionGrafo::Bloque>());
+            bloqueCopiado.push_back(true);
+        }
+        auto n = make_shared<NodoVersion>();
+        n->id = nueva->numNodos;
+        // El ultimo bloque puede seguir compartido con la version publicada
+        bloqueMutable(nueva->numNodos / VersionGrafo::TAM_BLOQUE).push_back(n);
+        nodoCopiado.insert(nueva->numNodos);
+        nueva->numNodos++;
+    }
+    NodoVersion& n = nodoMutable(id);
+    if (!n.nombre.empty()) nombresMutables().erase(n.nombre);
+    n.nombre = nombre;
+    nombresMutables()[nombre] = id;
+}
+
+void EdicionGrafo::bajaNodo(int id) {
+    if (!valido(id)) return;
+    nodoMutable(id).adj.clear();
+    for (int u = 0; u < nueva->numNodos; ++u) {
+        const auto& adj = nueva->nodo(u).adj;
+        bool apunta = any_of(adj.begin(), adj.end(), [id](const Arista& a) { return a.to == id; });
+        if (apunta) {
+            auto& mut = nodoMutable(u).adj;
+            mut.erase(remove_if(mut.begin(), mut.end(), [id](const Arista& a) { return a.to == id; }), mut.end());
+        }
+    }
+    NodoVersion& n = nodoMutable(id);
+    nombresMutables().erase(n.nombre);
+    n.nombre = "";
+}
+
+long GrafoVersionado::reconstruir(const Grafo& g) {
+    EdicionGrafo ed = editar();
+    auto v = make_shared<VersionGrafo>();
+    v->nombreToId = make_shared<unordered_map<string, int>>();
+    const auto& nodos = g.getNodos();
+    for (size_t i = 0; i < nodos.size(); ++i) {
+        if (i % VersionGrafo::TAM_BLOQUE == 0) v->bloques.push_back(make_shared<VersionGrafo::Bloque>());
+        auto n = make_shared<NodoVersion>(NodoVersion{static_cast<int>(i), string(nodos[i].nombre),
+            vector<Arista>(nodos[i].adj.begin(), nodos[i].adj.end())});
+        v->bloques.back()->push_back(n);
+        if (!n->nombre.empty()) (*v->nombreToId)[n->nombre] = static_cast<int>(i);
+    }
+    v->numNodos = static_cast<int>(nodos.size());
+    ed.nueva = v;
+    return publicar(ed);
+}
+
+}  // namespace trafico
@@ -0,0 +1,147 @@
+// Versiones inmutables de la red para lectores concurrentes.
+#ifndef TRAFICO_VERSIONADO_H
+#define TRAFICO_VERSIONADO_H
+
+#include "grafo.h"
+
+namespace trafico {
+
+// Nodo de una version inmutable: guarda su propio nombre y lista para no
+// depender de la arena ni del pool del grafo editable
+struct NodoVersion {
+    int id;
+    std::string nombre;
+    std::vector<Arista> adj;
+};
+
+// Version inmutable de la red. Los nodos se agrupan en bloques compartidos
+// entre versiones: una version nueva solo copia el indice de bloques, los
+// bloques que cambian y las listas de adyacencia modificadas.
+class VersionGrafo {
+    friend class GrafoVersionado;
+    friend class EdicionGrafo;
+
+public:
+    static const int TAM_BLOQUE = 256;
+
+private:
+    using Bloque = std::vector<std::shared_ptr<NodoVersion>>;
+    long numero = 0;
+    int numNodos = 0;
+    std::vector<std::shared_ptr<Bloque>> bloques;
+    std::shared_ptr<std::unordered_map<std::string, int>> nombreToId;
+
+public:
+    long getNumero() const { return numero; }
+    int getNumNodos() const { return numNodos; }
+
+    const NodoVersion& nodo(int id) const {
+        return *(*bloques[id / TAM_BLOQUE])[id % TAM_BLOQUE];
+    }
+
+    bool existe(int id) const {
+        return id >= 0 && id < numNodos && !nodo(id).nombre.empty();
+    }
+
+    int getIdByName(const std::string& name) const {
+        auto it = nombreToId->find(name);
+        return it != nombreToId->end() ? it->second : -1;
+    }
+
+    Ruta dijkstra(int s, int e) const {
+        return rutasDesde(s, {e})[0];
+    }
+
+    // Rutas desde s hacia varios destinos con un solo Dijkstra, que se detiene
+    // al asentar el ultimo destino pendiente
+    std::vector<Ruta> rutasDesde(int s, const std::vector<int>& destinos) const;
+
+    // Orden de visita en anchura o en profundidad desde s (mismo orden que
+    // Grafo::bfs y Grafo::dfs)
+    std::vector<int> recorrido(int s, bool anchura) const;
+};
+
+// Edicion en curso sobre la version actual. Mantiene el candado de escritura
+// hasta publicarse; copia cada bloque y cada nodo a lo sumo una vez.
+class EdicionGrafo {
+    friend class GrafoVersionado;
+
+private:
+    std::unique_lock<std::mutex> lock;
+    std::shared_ptr<VersionGrafo> nueva;
+    std::vector<bool> bloqueCopiado;
+    std::unordered_set<int> nodoCopiado;
+    bool nombresCopiados = false;
+
+    EdicionGrafo(std::mutex& m, const VersionGrafo& actual)
+        : lock(m), nueva(std::make_shared<VersionGrafo>(actual)),
+          bloqueCopiado(actual.bloques.size(), false) {}
+
+    // Copia el bloque b la primera vez que esta edicion lo modifica
+    VersionGrafo::Bloque& bloqueMutable(int b);
+
+    NodoVersion& nodoMutable(int id);
+
+    std::unordered_map<std::string, int>& nombresMutables() {
+        if (!nombresCopiados) {
+            nueva->nombreToId = std::make_shared<std::unordered_map<std::string, int>>(*nueva->nombreToId);
+            nombresCopiados = true;
+        }
+        return *nueva->nombreToId;
+    }
+
+    bool valido(int id) const { return id >= 0 && id < nueva->numNodos; }
+
+public:
+    const VersionGrafo& version() const { return *nueva; }
+
+    void altaNodo(int id, const std::string& nombre);
+
+    void bajaNodo(int id);
+
+    void altaArista(int from, int to, float w) {
+        if (valido(from) && valido(to) && w >= 0) nodoMutable(from).adj.push_back({to, w});
+    }
+
+    void bajaArista(int from, int to) {
+        if (!valido(from)) return;
+        auto& adj = nodoMutable(from).adj;
+        adj.erase(std::remove_if(adj.begin(), adj.end(), [to](const Arista& a) { return a.to == to; }), adj.end());
+    }
+};
+
+// Red con versiones copy-on-write: los lectores fijan una version inmutable
+// y enrutan sobre ella sin candados; los escritores preparan la siguiente
+// version con EdicionGrafo y la publican de forma atomica.
+class GrafoVersionado {
+private:
+    std::shared_ptr<const VersionGrafo> actual;
+    std::mutex escritura;
+
+public:
+    GrafoVersionado() {
+        auto v = std::make_shared<VersionGrafo>();
+        v->nombreToId = std::make_shared<std::unordered_map<std::string, int>>();
+        actual = v;
+    }
+
+    // Los lectores conservan la version mientras tengan el puntero
+    std::shared_ptr<const VersionGrafo> fijar() const { return atomic_load(&actual); }
+
+    EdicionGrafo editar() { return EdicionGrafo(escritura, *fijar()); }
+
+    long publicar(EdicionGrafo& ed) {
+        ed.nueva->numero = fijar()->numero + 1;
+        long numero = ed.nueva->numero;
+        atomic_store(&actual, std::shared_ptr<const VersionGrafo>(std::move(ed.nueva)));
+        ed.lock.unlock();
+        return numero;
+    }
+
+    // Publica una version completa a partir de la red editable
+    long reconstruir(const Grafo& g);
+};
+
+}  // namespace trafico
+
+#endif